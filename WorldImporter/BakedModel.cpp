@@ -0,0 +1,148 @@
+﻿#include "BakedModel.h"
+#include "blockstate.h"
+#include <cmath>
+#include <stdexcept>
+#include <string>
+#include <unordered_map>
+
+namespace {
+    struct BakedMaterial {
+        std::string name;
+        std::string texturePath;
+    };
+
+    std::vector<BakedMaterial> bakedMaterials;                   // 下标为烘焙材质ID
+    std::unordered_map<std::string, uint16_t> bakedMaterialIds;  // 按材质名
+    std::unordered_map<const ModelData*, BakedModel> bakedModels;
+
+    constexpr float FixedScale = 65536.0f;
+
+    uint16_t InternMaterial(const std::string& name, const std::string& texturePath) {
+        auto it = bakedMaterialIds.find(name);
+        if (it != bakedMaterialIds.end()) {
+            return it->second;
+        }
+        if (bakedMaterials.size() >= NoBakedMaterial) {
+            throw std::runtime_error("too many materials");
+        }
+        uint16_t id = static_cast<uint16_t>(bakedMaterials.size());
+        bakedMaterials.push_back({ name, texturePath });
+        bakedMaterialIds.emplace(name, id);
+        return id;
+    }
+
+    void Bake(const ModelData& model) {
+        if (bakedModels.count(&model)) {
+            return;
+        }
+        BakedModel& baked = bakedModels[&model];
+        // 没有方向信息的模型不输出任何面
+        if (model.faceDirections.empty()) {
+            return;
+        }
+        if (model.faces.size() % 4 != 0) {
+            throw std::runtime_error("faces size is not a multiple of 4");
+        }
+
+        const size_t faceCount = model.faces.size() / 4;
+        baked.quads.reserve(faceCount);
+        for (size_t faceIdx = 0; faceIdx < faceCount; ++faceIdx) {
+            if (faceIdx >= model.faceDirections.size()) {
+                throw std::runtime_error("faceIdx out of range");
+            }
+            BakedQuad quad;
+            for (int k = 0; k < 4; ++k) {
+                const size_t v = static_cast<size_t>(model.faces[faceIdx * 4 + k]) * 3;
+                const size_t t = static_cast<size_t>(model.uvFaces[faceIdx * 4 + k]) * 2;
+                for (int c = 0; c < 3; ++c) {
+                    quad.position[k][c] = static_cast<int32_t>(std::lround(model.vertices[v + c] * FixedScale));
+                }
+                quad.uv[k][0] = model.uvCoordinates[t];
+                quad.uv[k][1] = model.uvCoordinates[t + 1];
+            }
+            int materialIndex = faceIdx < model.materialIndices.size() ? model.materialIndices[faceIdx] : -1;
+            quad.material = (materialIndex >= 0 && materialIndex < static_cast<int>(model.materialNames.size())) ?
+                InternMaterial(model.materialNames[materialIndex], model.texturePaths[materialIndex]) : NoBakedMaterial;
+            quad.cullFace = model.faceDirections[faceIdx];
+            baked.quads.push_back(quad);
+        }
+    }
+}
+
+void BakeModelCaches() {
+    bakedMaterials.clear();
+    bakedMaterialIds.clear();
+    bakedModels.clear();
+    for (const auto& ns : BlockModelCache) {
+        for (const auto& entry : ns.second) {
+            Bake(entry.second);
+        }
+    }
+    for (const auto& ns : VariantModelCache) {
+        for (const auto& entry : ns.second) {
+            for (const auto& wm : entry.second) {
+                Bake(wm.model);
+            }
+        }
+    }
+    for (const auto& ns : MultipartModelCache) {
+        for (const auto& entry : ns.second) {
+            for (const auto& parts : entry.second) {
+                for (const auto& wm : parts) {
+                    Bake(wm.model);
+                }
+            }
+        }
+    }
+}
+
+const BakedModel* FindBakedModel(const ModelData* model) {
+    auto it = bakedModels.find(model);
+    return it != bakedModels.end() ? &it->second : nullptr;
+}
+
+void BakedMaterialMap::Reset() {
+    for (uint16_t material : used) {
+        localIndex[material] = -1;
+    }
+    used.clear();
+}
+
+int BakedMaterialMap::Map(uint16_t material, ModelData& model) {
+    if (material == NoBakedMaterial) {
+        return -1;
+    }
+    if (localIndex.size() <= material) {
+        localIndex.resize(bakedMaterials.size(), -1);
+    }
+    int& index = localIndex[material];
+    if (index < 0) {
+        index = static_cast<int>(model.materialNames.size());
+        model.materialNames.push_back(bakedMaterials[material].name);
+        model.texturePaths.push_back(bakedMaterials[material].texturePath);
+        used.push_back(material);
+    }
+    return index;
+}
+
+void AppendBakedModel(const BakedModel& baked, int x, int y, int z, const bool visible[7],
+    BakedMaterialMap& materials, ModelData& out) {
+    const float offset[3] = { static_cast<float>(x), static_cast<float>(y), static_cast<float>(z) };
+    for (const BakedQuad& quad : baked.quads) {
+        if (!visible[quad.cullFace]) continue;
+
+        const int vertexBase = static_cast<int>(out.vertices.size() / 3);
+        const int uvBase = static_cast<int>(out.uvCoordinates.size() / 2);
+        for (int k = 0; k < 4; ++k) {
+            for (int c = 0; c < 3; ++c) {
+                out.vertices.push_back(quad.position[k][c] / FixedScale + offset[c]);
+            }
+            out.uvCoordinates.push_back(quad.uv[k][0]);
+            out.uvCoordinates.push_back(quad.uv[k][1]);
+            out.faces.push_back(vertexBase + k);
+            out.uvFaces.push_back(uvBase + k);
+        }
+        out.materialIndices.push_back(materials.Map(quad.material, out));
+        out.faceDirections.push_back(static_cast<FaceIndex>(quad.cullFace));
+    }
+}
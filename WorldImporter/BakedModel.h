@@ -0,0 +1,48 @@
+// BakedModel.h
+#ifndef BAKED_MODEL_H
+#define BAKED_MODEL_H
+
+#include "model.h"
+#include "OcclusionMask.h"
+#include <vector>
+#include <cstdint>
+
+// 烘焙后的四边形：位置为相对方块原点的 16.16 定点数，四个顶点的 UV 按面的顶点顺序保存
+struct BakedQuad {
+    int32_t position[4][3];
+    float uv[4][2];
+    uint16_t material;  // 烘焙材质ID，NoBakedMaterial 表示无材质
+    uint8_t cullFace;   // FaceIndex，FACE_NONE 表示不参与剔除
+};
+
+constexpr uint16_t NoBakedMaterial = 0xFFFF;
+
+// 模型缓存中一个模型的不可变四边形列表
+struct BakedModel {
+    std::vector<BakedQuad> quads;
+};
+
+// 烘焙 BlockModelCache / VariantModelCache / MultipartModelCache 中的全部模型
+// 在模型缓存建立之后、网格生成之前于主线程调用，之后的查询可以并发
+void BakeModelCaches();
+// 取模型缓存中某个模型的烘焙结果，不在缓存中时返回 nullptr
+const BakedModel* FindBakedModel(const ModelData* model);
+
+// 烘焙材质ID到输出模型材质下标的映射，每个输出模型使用前 Reset
+class BakedMaterialMap {
+public:
+    void Reset();
+    // 返回材质在 model 中的下标，首次出现时追加到 model 的材质列表
+    int Map(uint16_t material, ModelData& model);
+
+private:
+    std::vector<int> localIndex;    // 按烘焙材质ID，-1 表示尚未加入
+    std::vector<uint16_t> used;
+};
+
+// 把 visible[cullFace] 为真的四边形平移到方块 (x, y, z) 后追加到 out，同时记录每个面的 cullFace
+// visible 按 FaceIndex 下标，共 7 项（含 FACE_NONE）
+void AppendBakedModel(const BakedModel& baked, int x, int y, int z, const bool visible[7],
+    BakedMaterialMap& materials, ModelData& out);
+
+#endif // BAKED_MODEL_H
@@ -0,0 +1,163 @@
+﻿#include "BlockStateRegistry.h"
+#include <utility>
+
+namespace {
+    // 每线程复用的键缓冲，稳定后不再分配内存
+    thread_local std::string keyBuffer;
+
+    constexpr size_t InitialCapacity = 1024;
+
+    void SortProperties(BlockStateProperty* properties, size_t count) {
+        // 属性通常只有几个，插入排序即可
+        for (size_t i = 1; i < count; ++i) {
+            BlockStateProperty value = properties[i];
+            size_t j = i;
+            while (j > 0 && value.key < properties[j - 1].key) {
+                properties[j] = properties[j - 1];
+                --j;
+            }
+            properties[j] = value;
+        }
+    }
+}
+
+BlockStateRegistry::Table::Table(size_t capacity)
+    : mask(capacity - 1), slots(new std::atomic<const Entry*>[capacity]) {
+    for (size_t i = 0; i < capacity; ++i) {
+        slots[i].store(nullptr, std::memory_order_relaxed);
+    }
+}
+
+BlockStateRegistry::BlockStateRegistry(InsertHook onInsert) : onInsert(std::move(onInsert)) {
+    tables.push_back(std::make_unique<Table>(InitialCapacity));
+    table.store(tables.back().get(), std::memory_order_release);
+}
+
+BlockStateRegistry::~BlockStateRegistry() = default;
+
+void BlockStateRegistry::BuildKey(std::string_view name, BlockStateProperty* properties, size_t count, std::string& key) {
+    SortProperties(properties, count);
+    key.assign(name);
+    for (size_t i = 0; i < count; ++i) {
+        key += '\0';
+        key.append(properties[i].key);
+        key += '\1';
+        key.append(properties[i].value);
+    }
+}
+
+uint64_t BlockStateRegistry::HashKey(std::string_view key) {
+    // FNV-1a
+    uint64_t hash = 14695981039346656037ull;
+    for (char c : key) {
+        hash ^= static_cast<uint8_t>(c);
+        hash *= 1099511628211ull;
+    }
+    return hash;
+}
+
+int BlockStateRegistry::FindIn(const Table& table, std::string_view key, uint64_t hash) {
+    for (size_t i = hash & table.mask;; i = (i + 1) & table.mask) {
+        const Entry* entry = table.slots[i].load(std::memory_order_acquire);
+        if (entry == nullptr) {
+            return -1;
+        }
+        if (entry->hash == hash && entry->key == key) {
+            return entry->id;
+        }
+    }
+}
+
+void BlockStateRegistry::InsertInto(Table& table, const Entry* entry) {
+    size_t i = entry->hash & table.mask;
+    while (table.slots[i].load(std::memory_order_relaxed) != nullptr) {
+        i = (i + 1) & table.mask;
+    }
+    table.slots[i].store(entry, std::memory_order_release);
+}
+
+int BlockStateRegistry::Find(std::string_view name, BlockStateProperty* properties, size_t count) const {
+    BuildKey(name, properties, count, keyBuffer);
+    return FindIn(*table.load(std::memory_order_acquire), keyBuffer, HashKey(keyBuffer));
+}
+
+int BlockStateRegistry::Intern(std::string_view name, BlockStateProperty* properties, size_t count) {
+    BuildKey(name, properties, count, keyBuffer);
+    uint64_t hash = HashKey(keyBuffer);
+
+    // 无锁快速路径
+    int id = FindIn(*table.load(std::memory_order_acquire), keyBuffer, hash);
+    if (id >= 0) {
+        return id;
+    }
+
+    std::lock_guard<std::mutex> lock(writeMutex);
+    Table* current = table.load(std::memory_order_relaxed);
+    id = FindIn(*current, keyBuffer, hash);
+    if (id >= 0) {
+        return id;
+    }
+
+    // 负载超过一半时扩容：新表填好后再发布，旧表继续保留
+    if ((entries.size() + 1) * 2 > current->mask + 1) {
+        auto grown = std::make_unique<Table>((current->mask + 1) * 2);
+        for (const auto& entry : entries) {
+            InsertInto(*grown, entry.get());
+        }
+        current = grown.get();
+        tables.push_back(std::move(grown));
+        table.store(current, std::memory_order_release);
+    }
+
+    auto entry = std::make_unique<Entry>();
+    entry->hash = hash;
+    entry->key = keyBuffer;
+    entry->canonicalName.assign(name);
+    if (count > 0) {
+        entry->canonicalName += '[';
+        for (size_t i = 0; i < count; ++i) {
+            if (i > 0) entry->canonicalName += ',';
+            entry->canonicalName.append(properties[i].key);
+            entry->canonicalName += ':';
+            entry->canonicalName.append(properties[i].value);
+        }
+        entry->canonicalName += ']';
+    }
+    entry->id = static_cast<int>(entries.size());
+
+    // 回调完成后才把条目放入表中，其他线程拿到ID时对应数据已就绪
+    if (onInsert) {
+        onInsert(entry->id, entry->canonicalName);
+    }
+    InsertInto(*current, entry.get());
+    id = entry->id;
+    entries.push_back(std::move(entry));
+    stateCount.store(entries.size(), std::memory_order_release);
+    return id;
+}
+
+int BlockStateRegistry::Intern(std::string_view blockName) {
+    std::string_view name = blockName;
+    thread_local std::vector<BlockStateProperty> properties;
+    properties.clear();
+
+    size_t bracketPos = blockName.find('[');
+    if (bracketPos != std::string_view::npos) {
+        name = blockName.substr(0, bracketPos);
+        std::string_view states = blockName.substr(bracketPos + 1);
+        if (!states.empty() && states.back() == ']') {
+            states.remove_suffix(1);
+        }
+        while (!states.empty()) {
+            size_t end = states.find(',');
+            std::string_view pair = states.substr(0, end);
+            size_t colonPos = pair.find(':');
+            if (colonPos != std::string_view::npos) {
+                properties.push_back({ pair.substr(0, colonPos), pair.substr(colonPos + 1) });
+            }
+            if (end == std::string_view::npos) break;
+            states.remove_prefix(end + 1);
+        }
+    }
+    return Intern(name, properties.data(), properties.size());
+}
@@ -0,0 +1,72 @@
+// BlockStateRegistry.h
+#ifndef BLOCK_STATE_REGISTRY_H
+#define BLOCK_STATE_REGISTRY_H
+
+#include <atomic>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <string_view>
+#include <vector>
+#include <cstddef>
+#include <cstdint>
+
+// 方块状态属性（键值均为视图，只需在 Intern 调用期间有效）
+struct BlockStateProperty {
+    std::string_view key;
+    std::string_view value;
+};
+
+// 线程安全的方块状态驻留表：以 (方块名, 按键排序的属性) 为键分配稳定的整数ID
+// 查找走无锁路径（开放寻址表 + 原子槽位），只有首次注册时加锁；
+// 扩容时旧表保留到注册表析构，正在读旧表的线程不受影响
+class BlockStateRegistry {
+public:
+    // 新状态注册时回调（在写锁内，先于ID对其他线程可见），canonicalName 为 "name[key:value,...]"
+    using InsertHook = std::function<void(int id, const std::string& canonicalName)>;
+
+    explicit BlockStateRegistry(InsertHook onInsert = nullptr);
+    ~BlockStateRegistry();
+
+    BlockStateRegistry(const BlockStateRegistry&) = delete;
+    BlockStateRegistry& operator=(const BlockStateRegistry&) = delete;
+
+    // 返回状态ID，未注册时注册；properties 可以无序，会在原数组上按键排序
+    int Intern(std::string_view name, BlockStateProperty* properties, size_t count);
+    // 解析 "name[key:value,...]" 形式的方块名后驻留
+    int Intern(std::string_view blockName);
+    // 只查找不注册，不存在时返回 -1
+    int Find(std::string_view name, BlockStateProperty* properties, size_t count) const;
+
+    // 已注册的状态数
+    size_t size() const { return stateCount.load(std::memory_order_acquire); }
+
+private:
+    struct Entry {
+        uint64_t hash;
+        std::string key;            // name\0key\1value\0key\1value...
+        std::string canonicalName;  // name[key:value,...]
+        int id;
+    };
+
+    struct Table {
+        explicit Table(size_t capacity);
+        size_t mask;
+        std::unique_ptr<std::atomic<const Entry*>[]> slots;
+    };
+
+    static void BuildKey(std::string_view name, BlockStateProperty* properties, size_t count, std::string& key);
+    static uint64_t HashKey(std::string_view key);
+    static int FindIn(const Table& table, std::string_view key, uint64_t hash);
+    static void InsertInto(Table& table, const Entry* entry);
+
+    std::atomic<Table*> table;
+    std::atomic<size_t> stateCount{ 0 };
+    std::vector<std::unique_ptr<Table>> tables;     // 包括已被替换的旧表
+    std::vector<std::unique_ptr<Entry>> entries;    // 按ID顺序
+    std::mutex writeMutex;
+    InsertHook onInsert;
+};
+
+#endif // BLOCK_STATE_REGISTRY_H
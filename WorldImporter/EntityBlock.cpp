@@ -179,9 +179,7 @@ ModelData EntityBlock::GenerateLightBlockModel(const string& texturePath) {
     cubeModel.texturePaths = { "None" };
     cubeModel.materialIndices = vector<int>(6, 0);
 
-    cubeModel.faceDirections = {
-        "DO_NOT_CULL", "DO_NOT_CULL", "DO_NOT_CULL", "DO_NOT_CULL", "DO_NOT_CULL", "DO_NOT_CULL","DO_NOT_CULL", "DO_NOT_CULL", "DO_NOT_CULL", "DO_NOT_CULL", "DO_NOT_CULL", "DO_NOT_CULL","DO_NOT_CULL", "DO_NOT_CULL", "DO_NOT_CULL", "DO_NOT_CULL", "DO_NOT_CULL", "DO_NOT_CULL","DO_NOT_CULL", "DO_NOT_CULL", "DO_NOT_CULL", "DO_NOT_CULL", "DO_NOT_CULL", "DO_NOT_CULL"
-    };
+    cubeModel.faceDirections = vector<FaceIndex>(6, FACE_NONE);
 
     return cubeModel;
 }
\ No newline at end of file
@@ -0,0 +1,66 @@
+// FaceDirection.h
+#ifndef FACE_DIRECTION_H
+#define FACE_DIRECTION_H
+
+#include <cstdint>
+#include <string_view>
+
+// 面方向下标，与 GetBlockIdWithNeighbors 的 neighborIsAir 顺序一致
+// FACE_NONE 表示不参与剔除的面（DO_NOT_CULL）
+enum FaceIndex : uint8_t {
+    FACE_UP = 0, FACE_DOWN = 1, FACE_WEST = 2, FACE_EAST = 3, FACE_NORTH = 4, FACE_SOUTH = 5, FACE_NONE = 6
+};
+
+// 由模型 JSON 中的方向名解析，其他名称返回 FACE_NONE
+inline FaceIndex ParseFaceIndex(std::string_view name) {
+    if (name == "up") return FACE_UP;
+    if (name == "down") return FACE_DOWN;
+    if (name == "west") return FACE_WEST;
+    if (name == "east") return FACE_EAST;
+    if (name == "north") return FACE_NORTH;
+    if (name == "south") return FACE_SOUTH;
+    return FACE_NONE;
+}
+
+inline const char* FaceIndexName(FaceIndex face) {
+    static const char* const names[7] = { "up", "down", "west", "east", "north", "south", "DO_NOT_CULL" };
+    return names[face];
+}
+
+// 绕 Y 轴旋转 90 度：north -> east -> south -> west -> north
+constexpr FaceIndex FaceRotateY90[7] = { FACE_UP, FACE_DOWN, FACE_NORTH, FACE_SOUTH, FACE_EAST, FACE_WEST, FACE_NONE };
+// 绕 X 轴旋转 270 度：north -> up -> south -> down -> north
+constexpr FaceIndex FaceRotateX270[7] = { FACE_SOUTH, FACE_NORTH, FACE_WEST, FACE_EAST, FACE_UP, FACE_DOWN, FACE_NONE };
+
+// 方块状态旋转查找表，下标为 [X 方向步数][Y 方向步数][面]，先绕 X 再绕 Y
+struct FaceRotationTable {
+    FaceIndex faces[4][4][7];
+
+    constexpr FaceRotationTable() : faces() {
+        for (int x = 0; x < 4; ++x) {
+            for (int y = 0; y < 4; ++y) {
+                for (int f = 0; f < 7; ++f) {
+                    FaceIndex face = static_cast<FaceIndex>(f);
+                    for (int i = 0; i < x; ++i) face = FaceRotateX270[face];
+                    for (int i = 0; i < y; ++i) face = FaceRotateY90[face];
+                    faces[x][y][f] = face;
+                }
+            }
+        }
+    }
+};
+
+constexpr FaceRotationTable faceRotationTable{};
+
+// 方块状态 x/y 旋转（0/90/180/270，其他值视为 0）后的面方向
+constexpr FaceIndex RotateFace(FaceIndex face, int rotationX, int rotationY) {
+    const int xSteps = rotationX == 270 ? 1 : rotationX == 180 ? 2 : rotationX == 90 ? 3 : 0;
+    const int ySteps = rotationY == 90 ? 1 : rotationY == 180 ? 2 : rotationY == 270 ? 3 : 0;
+    return faceRotationTable.faces[xSteps][ySteps][face];
+}
+
+static_assert(RotateFace(FACE_NORTH, 0, 90) == FACE_EAST, "y rotation");
+static_assert(RotateFace(FACE_NORTH, 90, 0) == FACE_DOWN, "x rotation");
+static_assert(RotateFace(FACE_UP, 90, 90) == FACE_EAST, "x then y rotation");
+
+#endif // FACE_DIRECTION_H
@@ -0,0 +1,276 @@
+﻿#include "GreedyMesher.h"
+#include "blockstate.h"
+#include <cmath>
+#include <cstring>
+#include <string>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+namespace {
+    // 面的外观：材质、四个顶点所在的面内角点（决定绕序）以及面内坐标到 UV 的映射
+    // uv = uvOrigin + a * uvA + b * uvB，a、b 为面内两轴上的坐标
+    struct FaceAppearance {
+        std::string materialName;
+        std::string texturePath;
+        int8_t corner[4][2];
+        int8_t uvOrigin[2];
+        int8_t uvA[2];
+        int8_t uvB[2];
+    };
+
+    // 各方向的法线轴、面内两轴（0=x, 1=y, 2=z）以及面是否位于正侧
+    struct FaceAxes {
+        int normal, axisA, axisB;
+        bool positive;
+    };
+    constexpr FaceAxes faceAxes[6] = {
+        { 1, 0, 2, true },   // up
+        { 1, 0, 2, false },  // down
+        { 0, 2, 1, false },  // west
+        { 0, 2, 1, true },   // east
+        { 2, 0, 1, false },  // north
+        { 2, 0, 1, true },   // south
+    };
+
+    std::vector<FaceAppearance> appearances;                        // 下标为外观ID - 1
+    std::unordered_map<std::string, uint32_t> appearanceIds;
+    std::unordered_map<const ModelData*, GreedyCube> greedyCubes;
+
+    // 浮点值接近整数 0/±1 时写入 out
+    bool NearUnit(float value, int8_t& out) {
+        const float eps = 1e-4f;
+        for (int candidate = -1; candidate <= 1; ++candidate) {
+            if (std::fabs(value - candidate) < eps) {
+                out = static_cast<int8_t>(candidate);
+                return true;
+            }
+        }
+        return false;
+    }
+
+    uint32_t InternAppearance(const FaceAppearance& face) {
+        std::string key = face.materialName;
+        key += '\0';
+        key += face.texturePath;
+        key += '\0';
+        key.append(reinterpret_cast<const char*>(face.corner), sizeof(face.corner));
+        key.append(reinterpret_cast<const char*>(face.uvOrigin), sizeof(face.uvOrigin));
+        key.append(reinterpret_cast<const char*>(face.uvA), sizeof(face.uvA));
+        key.append(reinterpret_cast<const char*>(face.uvB), sizeof(face.uvB));
+        auto it = appearanceIds.find(key);
+        if (it != appearanceIds.end()) {
+            return it->second;
+        }
+        appearances.push_back(face);
+        uint32_t id = static_cast<uint32_t>(appearances.size());
+        appearanceIds.emplace(std::move(key), id);
+        return id;
+    }
+
+    // 从烘焙后的模型中识别完整立方体，逐面求出外观
+    bool AnalyzeCube(const ModelData& model, GreedyCube& cube) {
+        if (model.faces.size() != 24 || model.uvFaces.size() != 24 ||
+            model.materialIndices.size() != 6 || model.faceDirections.size() != 6) {
+            return false;
+        }
+
+        bool seen[6] = {};
+        FaceAppearance faces[6];
+        for (int f = 0; f < 6; ++f) {
+            int d = model.faceDirections[f];
+            if (d == FACE_NONE || seen[d]) {
+                return false;
+            }
+            seen[d] = true;
+            const FaceAxes& axes = faceAxes[d];
+
+            int materialIndex = model.materialIndices[f];
+            if (materialIndex < 0 || materialIndex >= static_cast<int>(model.materialNames.size())) {
+                return false;
+            }
+            FaceAppearance& face = faces[d];
+            face.materialName = model.materialNames[materialIndex];
+            face.texturePath = materialIndex < static_cast<int>(model.texturePaths.size()) ? model.texturePaths[materialIndex] : "";
+
+            // 四个顶点必须在单位立方体的对应面上，且恰好占据面内的四个角
+            float cornerUV[4][2];
+            int cornerMask = 0;
+            for (int k = 0; k < 4; ++k) {
+                size_t v = static_cast<size_t>(model.faces[f * 4 + k]) * 3;
+                size_t t = static_cast<size_t>(model.uvFaces[f * 4 + k]) * 2;
+                if (v + 2 >= model.vertices.size() || t + 1 >= model.uvCoordinates.size()) {
+                    return false;
+                }
+                int8_t n, a, b;
+                if (!NearUnit(model.vertices[v + axes.normal], n) || n != (axes.positive ? 1 : 0) ||
+                    !NearUnit(model.vertices[v + axes.axisA], a) || a < 0 ||
+                    !NearUnit(model.vertices[v + axes.axisB], b) || b < 0) {
+                    return false;
+                }
+                face.corner[k][0] = a;
+                face.corner[k][1] = b;
+                cornerMask |= 1 << (a + b * 2);
+                cornerUV[a + b * 2][0] = model.uvCoordinates[t];
+                cornerUV[a + b * 2][1] = model.uvCoordinates[t + 1];
+            }
+            if (cornerMask != 0xF) {
+                return false;
+            }
+
+            // UV 必须是整张纹理的旋转/镜像：原点在纹理角上，两轴为互相垂直的单位向量
+            for (int c = 0; c < 2; ++c) {
+                if (!NearUnit(cornerUV[0][c], face.uvOrigin[c]) || face.uvOrigin[c] < 0 ||
+                    !NearUnit(cornerUV[1][c] - cornerUV[0][c], face.uvA[c]) ||
+                    !NearUnit(cornerUV[2][c] - cornerUV[0][c], face.uvB[c]) ||
+                    std::fabs(cornerUV[3][c] - (cornerUV[1][c] + cornerUV[2][c] - cornerUV[0][c])) > 1e-4f) {
+                    return false;
+                }
+            }
+            if (std::abs(face.uvA[0]) + std::abs(face.uvA[1]) != 1 ||
+                std::abs(face.uvB[0]) + std::abs(face.uvB[1]) != 1 ||
+                face.uvA[0] * face.uvB[0] + face.uvA[1] * face.uvB[1] != 0) {
+                return false;
+            }
+        }
+
+        for (int d = 0; d < 6; ++d) {
+            cube.faceKey[d] = InternAppearance(faces[d]);
+        }
+        return true;
+    }
+
+    void AddModel(const ModelData* model) {
+        if (!model || greedyCubes.count(model)) {
+            return;
+        }
+        GreedyCube cube;
+        if (AnalyzeCube(*model, cube)) {
+            greedyCubes.emplace(model, cube);
+        }
+    }
+}
+
+void BuildGreedyCubeTable() {
+    appearances.clear();
+    appearanceIds.clear();
+    greedyCubes.clear();
+    for (const BlockStateInfo& info : blockStateInfos) {
+        if (info.model.kind == BlockModelHandle::Fixed) {
+            AddModel(info.model.model);
+        }
+        else if (info.model.kind == BlockModelHandle::Variant) {
+            for (const auto& wm : *info.model.variants) {
+                AddModel(&wm.model);
+            }
+        }
+    }
+}
+
+const GreedyCube* FindGreedyCube(const ModelData* model) {
+    if (!model) {
+        return nullptr;
+    }
+    auto it = greedyCubes.find(model);
+    return it != greedyCubes.end() ? &it->second : nullptr;
+}
+
+void GreedyFaceMask::Reset() {
+    if (dirty) {
+        std::memset(keys, 0, sizeof(keys));
+        dirty = false;
+    }
+}
+
+void EmitGreedyFaces(GreedyFaceMask& mask, int blockXStart, int blockYStart, int blockZStart, ModelData& model) {
+    if (!mask.dirty) {
+        return;
+    }
+    const int origin[3] = { blockXStart, blockYStart, blockZStart };
+    // 外观ID -> 本模型中的材质下标
+    std::vector<std::pair<uint32_t, int>> materialMap;
+
+    for (int d = 0; d < 6; ++d) {
+        const FaceAxes& axes = faceAxes[d];
+        uint32_t* keys = mask.keys[d];
+        for (int layer = 0; layer < 16; ++layer) {
+            int coord[3];
+            coord[axes.normal] = layer;
+            // 面内坐标 (a, b) 对应的 yzx 下标
+            auto indexOf = [&](int a, int b) {
+                coord[axes.axisA] = a;
+                coord[axes.axisB] = b;
+                return (coord[1] << 8) | (coord[2] << 4) | coord[0];
+            };
+
+            for (int b = 0; b < 16; ++b) {
+                for (int a = 0; a < 16; ++a) {
+                    uint32_t key = keys[indexOf(a, b)];
+                    if (key == 0) continue;
+
+                    // 先沿 a 方向扩展，再整行沿 b 方向扩展
+                    int width = 1;
+                    while (a + width < 16 && keys[indexOf(a + width, b)] == key) ++width;
+                    int height = 1;
+                    for (; b + height < 16; ++height) {
+                        bool rowMatches = true;
+                        for (int i = 0; i < width && rowMatches; ++i) {
+                            rowMatches = keys[indexOf(a + i, b + height)] == key;
+                        }
+                        if (!rowMatches) break;
+                    }
+                    for (int j = 0; j < height; ++j) {
+                        for (int i = 0; i < width; ++i) {
+                            keys[indexOf(a + i, b + j)] = 0;
+                        }
+                    }
+
+                    const FaceAppearance& face = appearances[key - 1];
+                    int materialIndex = -1;
+                    for (const auto& entry : materialMap) {
+                        if (entry.first == key) {
+                            materialIndex = entry.second;
+                            break;
+                        }
+                    }
+                    if (materialIndex < 0) {
+                        for (size_t m = 0; m < model.materialNames.size(); ++m) {
+                            if (model.materialNames[m] == face.materialName) {
+                                materialIndex = static_cast<int>(m);
+                                break;
+                            }
+                        }
+                        if (materialIndex < 0) {
+                            materialIndex = static_cast<int>(model.materialNames.size());
+                            model.materialNames.push_back(face.materialName);
+                            model.texturePaths.push_back(face.texturePath);
+                        }
+                        materialMap.emplace_back(key, materialIndex);
+                    }
+
+                    // 按原面的角点顺序输出，保持绕序；UV 随尺寸延伸，整数倍处正好接上下一块纹理
+                    const int vertexBase = static_cast<int>(model.vertices.size() / 3);
+                    const int uvBase = static_cast<int>(model.uvCoordinates.size() / 2);
+                    for (int k = 0; k < 4; ++k) {
+                        int ca = face.corner[k][0];
+                        int cb = face.corner[k][1];
+                        float position[3];
+                        position[axes.normal] = static_cast<float>(origin[axes.normal] + layer + (axes.positive ? 1 : 0));
+                        position[axes.axisA] = static_cast<float>(origin[axes.axisA] + a + ca * width);
+                        position[axes.axisB] = static_cast<float>(origin[axes.axisB] + b + cb * height);
+                        model.vertices.insert(model.vertices.end(), { position[0], position[1], position[2] });
+                        for (int c = 0; c < 2; ++c) {
+                            model.uvCoordinates.push_back(static_cast<float>(
+                                face.uvOrigin[c] + ca * width * face.uvA[c] + cb * height * face.uvB[c]));
+                        }
+                        model.faces.push_back(vertexBase + k);
+                        model.uvFaces.push_back(uvBase + k);
+                    }
+                    model.materialIndices.push_back(materialIndex);
+                    model.faceDirections.push_back(static_cast<FaceIndex>(d));
+                }
+            }
+        }
+    }
+    mask.dirty = false;
+}
@@ -0,0 +1,38 @@
+// GreedyMesher.h
+#ifndef GREEDY_MESHER_H
+#define GREEDY_MESHER_H
+
+#include "model.h"
+#include "OcclusionMask.h"
+#include <cstdint>
+
+// 完整单位立方体模型六个面的外观ID（按 FaceIndex 顺序，从 1 开始）
+// 外观相同的相邻共面面可以合并为一个大四边形
+struct GreedyCube {
+    uint32_t faceKey[6];
+};
+
+// 为 blockStateInfos 引用的固定/变种模型建立完整立方体表
+// 在模型解析之后、网格生成之前于主线程调用，之后的查询可以并发
+void BuildGreedyCubeTable();
+// 模型是完整单位立方体、六个面都参与剔除且各贴满一整张纹理时返回其外观，否则返回 nullptr
+const GreedyCube* FindGreedyCube(const ModelData* model);
+
+// 子区块内待合并的面：keys[face][yzx] 为外观ID，0 表示该处没有面
+struct GreedyFaceMask {
+    uint32_t keys[6][4096];
+    bool dirty = false;
+
+    void Set(int face, int yzx, uint32_t key) {
+        keys[face][yzx] = key;
+        dirty = true;
+    }
+    // 清除上次未输出的面（异常中断时）
+    void Reset();
+};
+
+// 逐方向、逐层合并 mask 中的面并追加到 model（世界坐标），输出后 mask 被清空
+// 合并面的 UV 按四边形尺寸缩放，纹理以重复方式平铺
+void EmitGreedyFaces(GreedyFaceMask& mask, int blockXStart, int blockYStart, int blockZStart, ModelData& model);
+
+#endif // GREEDY_MESHER_H
@@ -42,11 +42,7 @@ JarReader::JarReader(const std::wstring& jarFilePath)
 
     // 打开 .jar 文件（本质上是 .zip 文件）
     int error = 0;
-#ifdef _WIN32
     zipFile = zip_open(utf8Path.c_str(), 0, &error);  // 使用 UTF-8 路径打开
-#else
-    zipFile = zip_open(jarFilePath.c_str(), 0, &error); // Linux/macOS 直接使用宽字符路径
-#endif
     if (!zipFile) {
         std::cerr << "Failed to open .jar file: " << utf8Path << std::endl;
         return;
@@ -0,0 +1,294 @@
+﻿#include "MeshCache.h"
+#include "GlobalCache.h"
+#include "fileutils.h"
+#include <algorithm>
+#include <fstream>
+#include <sstream>
+#include <iostream>
+#include <filesystem>
+#include <iterator>
+#include <system_error>
+
+using namespace std;
+
+namespace {
+    const char MESH_CACHE_MAGIC[4] = { 'W', 'I', 'M', 'C' };
+    const uint32_t MESH_CACHE_VERSION = 3;
+
+    // FNV-1a 64 位哈希
+    void HashBytes(uint64_t& hash, const void* data, size_t size) {
+        const unsigned char* bytes = static_cast<const unsigned char*>(data);
+        for (size_t i = 0; i < size; ++i) {
+            hash ^= bytes[i];
+            hash *= 1099511628211ULL;
+        }
+    }
+
+    void HashString(uint64_t& hash, const string& value) {
+        HashBytes(hash, value.data(), value.size());
+        HashBytes(hash, "\0", 1); // 分隔符，避免 "ab"+"c" 与 "a"+"bc" 冲突
+    }
+
+    // 哈希文件内容，使同一路径下的文件被修改后缓存失效；文件不存在时只记录长度 0
+    void HashFileContents(uint64_t& hash, const string& path) {
+        ifstream in(path, ios::binary);
+        string contents;
+        if (in) {
+            contents.assign(istreambuf_iterator<char>(in), istreambuf_iterator<char>());
+        }
+        uint64_t size = contents.size();
+        HashBytes(hash, &size, sizeof(size));
+        HashBytes(hash, contents.data(), contents.size());
+    }
+
+    // 哈希文件（目录则为其下所有文件）的相对路径、大小与修改时间；
+    // 模组和资源包通常有数百 MB，不逐字节读取内容
+    void HashFileStamp(uint64_t& hash, const string& path) {
+        namespace fs = std::filesystem;
+        fs::path root(string_to_wstring(path));
+        std::error_code error;
+
+        vector<fs::path> files;
+        if (fs::is_directory(root, error)) {
+            for (fs::recursive_directory_iterator it(root, error), end; !error && it != end; it.increment(error)) {
+                if (it->is_regular_file(error)) {
+                    files.push_back(it->path());
+                }
+            }
+            // 遍历顺序由文件系统决定，排序后哈希才稳定
+            sort(files.begin(), files.end());
+        }
+        else {
+            files.push_back(root);
+        }
+
+        uint64_t count = files.size();
+        HashBytes(hash, &count, sizeof(count));
+        for (const auto& file : files) {
+            // 直接哈希本机编码的相对路径，不经过字符集转换
+            auto relative = file.lexically_relative(root).native();
+            HashBytes(hash, relative.data(), relative.size() * sizeof(relative[0]));
+            uint64_t size = fs::file_size(file, error);
+            if (error) size = 0;
+            auto stamp = fs::last_write_time(file, error).time_since_epoch().count();
+            if (error) stamp = 0;
+            HashBytes(hash, &size, sizeof(size));
+            HashBytes(hash, &stamp, sizeof(stamp));
+        }
+    }
+
+    template <typename T>
+    void WritePod(ofstream& out, const T& value) {
+        out.write(reinterpret_cast<const char*>(&value), sizeof(T));
+    }
+
+    template <typename T>
+    bool ReadPod(ifstream& in, T& value) {
+        return static_cast<bool>(in.read(reinterpret_cast<char*>(&value), sizeof(T)));
+    }
+
+    template <typename T>
+    void WriteVector(ofstream& out, const vector<T>& values) {
+        uint32_t count = static_cast<uint32_t>(values.size());
+        WritePod(out, count);
+        out.write(reinterpret_cast<const char*>(values.data()), count * sizeof(T));
+    }
+
+    template <typename T>
+    bool ReadVector(ifstream& in, vector<T>& values) {
+        uint32_t count = 0;
+        if (!ReadPod(in, count)) return false;
+        values.resize(count);
+        return static_cast<bool>(in.read(reinterpret_cast<char*>(values.data()), count * sizeof(T)));
+    }
+
+    void WriteStrings(ofstream& out, const vector<string>& values) {
+        uint32_t count = static_cast<uint32_t>(values.size());
+        WritePod(out, count);
+        for (const auto& value : values) {
+            uint32_t length = static_cast<uint32_t>(value.size());
+            WritePod(out, length);
+            out.write(value.data(), length);
+        }
+    }
+
+    bool ReadStrings(ifstream& in, vector<string>& values) {
+        uint32_t count = 0;
+        if (!ReadPod(in, count)) return false;
+        values.resize(count);
+        for (auto& value : values) {
+            uint32_t length = 0;
+            if (!ReadPod(in, length)) return false;
+            value.resize(length);
+            if (!in.read(&value[0], length)) return false;
+        }
+        return true;
+    }
+
+    void WriteKey(ofstream& out, const MeshCacheKey& key) {
+        WritePod(out, key.chunkX);
+        WritePod(out, key.chunkZ);
+        WritePod(out, key.timestamp);
+        WritePod(out, key.neighborStamp);
+        WritePod(out, key.resourceHash);
+        WritePod(out, key.sectionYStart);
+        WritePod(out, key.sectionYEnd);
+    }
+
+    bool ReadKey(ifstream& in, MeshCacheKey& key) {
+        return ReadPod(in, key.chunkX) && ReadPod(in, key.chunkZ) &&
+            ReadPod(in, key.timestamp) && ReadPod(in, key.neighborStamp) &&
+            ReadPod(in, key.resourceHash) &&
+            ReadPod(in, key.sectionYStart) && ReadPod(in, key.sectionYEnd);
+    }
+}
+
+MeshCache::MeshCache(const string& directory) : directory(directory) {
+    std::error_code error;
+    std::filesystem::create_directories(directory, error);
+    if (error) {
+        cerr << "Failed to create directory: " << directory << endl;
+    }
+}
+
+string MeshCache::GetChunkPath(int chunkX, int chunkZ) const {
+    ostringstream pathStream;
+    pathStream << directory << "/c." << chunkX << "." << chunkZ << ".mesh";
+    return pathStream.str();
+}
+
+bool MeshCache::OpenAndCheck(const MeshCacheKey& key, ifstream& in) const {
+    in.open(GetChunkPath(key.chunkX, key.chunkZ), ios::binary);
+    if (!in) {
+        return false;
+    }
+
+    char magic[4];
+    uint32_t version = 0;
+    MeshCacheKey storedKey;
+    return in.read(magic, sizeof(magic)) && equal(magic, magic + 4, MESH_CACHE_MAGIC) &&
+        ReadPod(in, version) && version == MESH_CACHE_VERSION &&
+        ReadKey(in, storedKey) && storedKey == key;
+}
+
+bool MeshCache::Contains(const MeshCacheKey& key) const {
+    ifstream in;
+    return OpenAndCheck(key, in);
+}
+
+bool MeshCache::Load(const MeshCacheKey& key, vector<ModelData>& sectionModels) const {
+    ifstream in;
+    if (!OpenAndCheck(key, in)) {
+        return false;
+    }
+
+    // 文件头匹配但内容损坏（如旧版本写入中断），删除后由本次导出重新生成
+    auto discard = [&]() {
+        sectionModels.clear();
+        in.close();
+        std::error_code error;
+        std::filesystem::remove(GetChunkPath(key.chunkX, key.chunkZ), error);
+        return false;
+        };
+
+    uint32_t sectionCount = 0;
+    if (!ReadPod(in, sectionCount) ||
+        sectionCount != static_cast<uint32_t>(key.sectionYEnd - key.sectionYStart + 1)) {
+        return discard();
+    }
+
+    sectionModels.assign(sectionCount, ModelData());
+    for (auto& model : sectionModels) {
+        if (!ReadVector(in, model.vertices) || !ReadVector(in, model.uvCoordinates) ||
+            !ReadVector(in, model.faces) || !ReadVector(in, model.uvFaces) ||
+            !ReadVector(in, model.materialIndices) ||
+            !ReadStrings(in, model.materialNames) || !ReadStrings(in, model.texturePaths) ||
+            !ReadVector(in, model.faceDirections) || !ReadVector(in, model.faceNames)) {
+            return discard();
+        }
+    }
+    return true;
+}
+
+bool MeshCache::Store(const MeshCacheKey& key, const vector<ModelData>& sectionModels) const {
+    // 先写入临时文件再替换，写入中断时不会留下文件头有效、内容不完整的缓存
+    string path = GetChunkPath(key.chunkX, key.chunkZ);
+    string tempPath = path + ".tmp";
+    ofstream out(tempPath, ios::binary | ios::trunc);
+    if (!out) {
+        cerr << "错误: 无法写入网格缓存: " << tempPath << endl;
+        return false;
+    }
+
+    out.write(MESH_CACHE_MAGIC, sizeof(MESH_CACHE_MAGIC));
+    WritePod(out, MESH_CACHE_VERSION);
+    WriteKey(out, key);
+    WritePod(out, static_cast<uint32_t>(sectionModels.size()));
+    for (const auto& model : sectionModels) {
+        WriteVector(out, model.vertices);
+        WriteVector(out, model.uvCoordinates);
+        WriteVector(out, model.faces);
+        WriteVector(out, model.uvFaces);
+        WriteVector(out, model.materialIndices);
+        WriteStrings(out, model.materialNames);
+        WriteStrings(out, model.texturePaths);
+        WriteVector(out, model.faceDirections);
+        WriteVector(out, model.faceNames);
+    }
+    out.close();
+
+    std::error_code error;
+    if (!out) {
+        cerr << "错误: 无法写入网格缓存: " << tempPath << endl;
+        std::filesystem::remove(tempPath, error);
+        return false;
+    }
+    std::filesystem::rename(tempPath, path, error);
+    if (error) {
+        cerr << "错误: 无法替换网格缓存: " << path << endl;
+        std::filesystem::remove(tempPath, error);
+        return false;
+    }
+    return true;
+}
+
+uint64_t MeshCache::ComputeResourceHash(const Config& config) {
+    uint64_t hash = 14695981039346656037ULL;
+    HashBytes(hash, &MESH_CACHE_VERSION, sizeof(MESH_CACHE_VERSION));
+    HashString(hash, config.selectedGameVersion);
+    HashString(hash, config.solidBlocksFile);
+    HashFileContents(hash, config.solidBlocksFile);
+    HashString(hash, config.biomeMappingFile);
+    HashFileContents(hash, config.biomeMappingFile);
+    HashBytes(hash, &config.lodLevel, sizeof(config.lodLevel));
+    HashBytes(hash, &config.greedyMeshing, sizeof(config.greedyMeshing));
+    HashBytes(hash, &config.lodCenterX, sizeof(config.lodCenterX));
+    HashBytes(hash, &config.lodCenterZ, sizeof(config.lodCenterZ));
+    HashBytes(hash, &config.lodDistance, sizeof(config.lodDistance));
+
+    auto it = config.versionConfigs.find(config.selectedGameVersion);
+    if (it != config.versionConfigs.end()) {
+        const VersionConfig& version = it->second;
+        HashString(hash, version.gameFolderPath);
+        HashString(hash, version.minecraftVersion);
+        HashString(hash, version.modLoaderType);
+        for (const auto& mod : version.modList) {
+            HashString(hash, mod);
+        }
+        for (const auto& pack : version.resourcePackList) {
+            HashString(hash, pack);
+        }
+    }
+
+    // 模型、纹理、生物群系与色图都从这些 jar/资源包读取（与 GlobalCache 的加载顺序一致），
+    // 同名文件被替换或更新后缓存也会失效
+    for (const auto* folders : { &VersionCache, &resourcePacksCache, &modListCache }) {
+        auto found = folders->find(config.selectedGameVersion);
+        if (found == folders->end()) continue;
+        for (const auto& folder : found->second) {
+            HashString(hash, folder.path);
+            HashFileStamp(hash, folder.path);
+        }
+    }
+    return hash;
+}
@@ -0,0 +1,52 @@
+// MeshCache.h
+#ifndef MESH_CACHE_H
+#define MESH_CACHE_H
+
+#include "model.h"
+#include "config.h"
+#include <string>
+#include <fstream>
+#include <vector>
+#include <cstdint>
+
+// 网格缓存键：区块坐标 + 区域文件头时间戳 + 资源集合哈希
+// 边界面的剔除依赖四邻区块，因此邻居时间戳也参与比较
+struct MeshCacheKey {
+    int chunkX = 0;
+    int chunkZ = 0;
+    uint32_t timestamp = 0;        // 区块自身的修改时间（区域文件头）
+    uint64_t neighborStamp = 0;    // 四邻区块时间戳的组合
+    uint64_t resourceHash = 0;     // 整合包资源、模组与导出选项的哈希
+    int sectionYStart = 0;
+    int sectionYEnd = 0;
+
+    bool operator==(const MeshCacheKey& other) const {
+        return chunkX == other.chunkX && chunkZ == other.chunkZ &&
+            timestamp == other.timestamp && neighborStamp == other.neighborStamp &&
+            resourceHash == other.resourceHash &&
+            sectionYStart == other.sectionYStart && sectionYEnd == other.sectionYEnd;
+    }
+};
+
+// 增量导出使用的磁盘网格缓存，每个区块一个文件，保存各子区块剔除后的网格
+class MeshCache {
+public:
+    explicit MeshCache(const std::string& directory);
+
+    // 只读取文件头，判断缓存是否与键匹配
+    bool Contains(const MeshCacheKey& key) const;
+    // 键完全匹配时读取缓存的子区块网格（按 sectionY 从低到高）
+    bool Load(const MeshCacheKey& key, std::vector<ModelData>& sectionModels) const;
+    bool Store(const MeshCacheKey& key, const std::vector<ModelData>& sectionModels) const;
+
+    // 计算当前整合包版本、资源包、模组列表（含实际读取的 jar/资源包文件的大小与修改时间）及影响网格的导出选项的哈希
+    static uint64_t ComputeResourceHash(const Config& config);
+
+private:
+    bool OpenAndCheck(const MeshCacheKey& key, std::ifstream& in) const;
+    std::string GetChunkPath(int chunkX, int chunkZ) const;
+
+    std::string directory;
+};
+
+#endif // MESH_CACHE_H
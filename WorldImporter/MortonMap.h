@@ -0,0 +1,170 @@
+// MortonMap.h
+#ifndef MORTON_MAP_H
+#define MORTON_MAP_H
+
+#include <vector>
+#include <utility>
+#include <cstddef>
+#include <cstdint>
+
+// --------------------------------------------------------------------------------
+// Morton 编码键
+// --------------------------------------------------------------------------------
+// 把 32 位整数的各位分散到 64 位的偶数位上
+inline uint64_t SpreadBits32(uint32_t value) {
+    uint64_t x = value;
+    x = (x | (x << 16)) & 0x0000FFFF0000FFFFull;
+    x = (x | (x << 8)) & 0x00FF00FF00FF00FFull;
+    x = (x | (x << 4)) & 0x0F0F0F0F0F0F0F0Full;
+    x = (x | (x << 2)) & 0x3333333333333333ull;
+    x = (x | (x << 1)) & 0x5555555555555555ull;
+    return x;
+}
+
+// SpreadBits32 的逆运算，取 64 位中的偶数位
+inline uint32_t CompactBits32(uint64_t x) {
+    x &= 0x5555555555555555ull;
+    x = (x | (x >> 1)) & 0x3333333333333333ull;
+    x = (x | (x >> 2)) & 0x0F0F0F0F0F0F0F0Full;
+    x = (x | (x >> 4)) & 0x00FF00FF00FF00FFull;
+    x = (x | (x >> 8)) & 0x0000FFFF0000FFFFull;
+    x = (x | (x >> 16)) & 0x00000000FFFFFFFFull;
+    return static_cast<uint32_t>(x);
+}
+
+// 二维坐标（区域、区块）的 64 位 Morton 键，坐标翻转符号位后交错，相邻坐标的键也相近
+inline uint64_t MortonKey2D(int x, int z) {
+    return SpreadBits32(static_cast<uint32_t>(x) ^ 0x80000000u) |
+        (SpreadBits32(static_cast<uint32_t>(z) ^ 0x80000000u) << 1);
+}
+
+inline void DecodeMortonKey2D(uint64_t key, int& x, int& z) {
+    x = static_cast<int>(CompactBits32(key) ^ 0x80000000u);
+    z = static_cast<int>(CompactBits32(key >> 1) ^ 0x80000000u);
+}
+
+// 子区块键：区块 X/Z 各取 24 位（±838 万个区块，覆盖整个世界边界）交错后放在高 48 位，
+// 低 16 位为调整后的子区块 Y，同一列的子区块键连续
+inline uint64_t SectionKey(int chunkX, int chunkZ, int sectionY) {
+    uint32_t x = static_cast<uint32_t>(chunkX + (1 << 23)) & 0xFFFFFFu;
+    uint32_t z = static_cast<uint32_t>(chunkZ + (1 << 23)) & 0xFFFFFFu;
+    return ((SpreadBits32(x) | (SpreadBits32(z) << 1)) << 16) | static_cast<uint16_t>(sectionY);
+}
+
+inline void DecodeSectionKey(uint64_t key, int& chunkX, int& chunkZ, int& sectionY) {
+    uint64_t morton = key >> 16;
+    chunkX = static_cast<int>(CompactBits32(morton)) - (1 << 23);
+    chunkZ = static_cast<int>(CompactBits32(morton >> 1)) - (1 << 23);
+    sectionY = static_cast<int16_t>(key & 0xFFFF);
+}
+
+// --------------------------------------------------------------------------------
+// 以 64 位键索引的开放寻址哈希表（线性探测，删除时回移后续条目，不留墓碑）
+// 插入和删除会移动其他条目，需要稳定地址时让 V 持有指针
+// --------------------------------------------------------------------------------
+template <typename V>
+class MortonMap {
+public:
+    V* find(uint64_t key) {
+        if (count == 0) return nullptr;
+        for (size_t i = Home(key);; i = (i + 1) & mask) {
+            if (!used[i]) return nullptr;
+            if (slots[i].first == key) return &slots[i].second;
+        }
+    }
+
+    const V* find(uint64_t key) const {
+        return const_cast<MortonMap*>(this)->find(key);
+    }
+
+    // 不存在时插入默认值
+    V& operator[](uint64_t key) {
+        if ((count + 1) * 2 > slots.size()) {
+            Rehash(slots.empty() ? 64 : slots.size() * 2);
+        }
+        size_t i = Home(key);
+        for (; used[i]; i = (i + 1) & mask) {
+            if (slots[i].first == key) return slots[i].second;
+        }
+        used[i] = 1;
+        slots[i].first = key;
+        slots[i].second = V();
+        ++count;
+        return slots[i].second;
+    }
+
+    bool erase(uint64_t key) {
+        if (count == 0) return false;
+        size_t i = Home(key);
+        for (;; i = (i + 1) & mask) {
+            if (!used[i]) return false;
+            if (slots[i].first == key) break;
+        }
+
+        // 把探测链上后续的条目回移到空位，保持查找不中断
+        size_t hole = i;
+        for (size_t j = (i + 1) & mask; used[j]; j = (j + 1) & mask) {
+            size_t home = Home(slots[j].first);
+            bool movable = (hole <= j) ? (home <= hole || home > j) : (home <= hole && home > j);
+            if (movable) {
+                slots[hole] = std::move(slots[j]);
+                hole = j;
+            }
+        }
+        used[hole] = 0;
+        slots[hole].second = V();
+        --count;
+        return true;
+    }
+
+    // f(key, value)，遍历期间不能插入或删除
+    template <typename F>
+    void forEach(F&& f) {
+        for (size_t i = 0; i < slots.size(); ++i) {
+            if (used[i]) f(slots[i].first, slots[i].second);
+        }
+    }
+
+    size_t size() const { return count; }
+    bool empty() const { return count == 0; }
+
+    void clear() {
+        slots.clear();
+        used.clear();
+        count = 0;
+        mask = 0;
+        shift = 64;
+    }
+
+private:
+    // Fibonacci 散列取高位，Morton 键低位变化少时仍能分散
+    size_t Home(uint64_t key) const {
+        return static_cast<size_t>((key * 0x9E3779B97F4A7C15ull) >> shift);
+    }
+
+    void Rehash(size_t capacity) {
+        std::vector<std::pair<uint64_t, V>> oldSlots(capacity);
+        std::vector<uint8_t> oldUsed(capacity, 0);
+        oldSlots.swap(slots);
+        oldUsed.swap(used);
+        mask = capacity - 1;
+        shift = 64;
+        for (size_t c = capacity; c > 1; c >>= 1) --shift;
+
+        for (size_t i = 0; i < oldSlots.size(); ++i) {
+            if (!oldUsed[i]) continue;
+            size_t j = Home(oldSlots[i].first);
+            while (used[j]) j = (j + 1) & mask;
+            used[j] = 1;
+            slots[j] = std::move(oldSlots[i]);
+        }
+    }
+
+    std::vector<std::pair<uint64_t, V>> slots;
+    std::vector<uint8_t> used;
+    size_t count = 0;
+    size_t mask = 0;
+    int shift = 64;
+};
+
+#endif // MORTON_MAP_H
@@ -0,0 +1,402 @@
+﻿#include "NbtDocument.h"
+#include <algorithm>
+#include <stdexcept>
+#include <string>
+
+// --------------------------------------------------------------------------------
+// NbtSchema
+// --------------------------------------------------------------------------------
+NbtSchema::NbtSchema() {
+    entries.emplace_back();  // 根节点
+}
+
+NbtSchema& NbtSchema::Add(std::string_view path) {
+    uint32_t node = Root;
+    size_t start = 0;
+    while (start <= path.size()) {
+        size_t end = path.find('/', start);
+        if (end == std::string_view::npos) end = path.size();
+        std::string_view segment = path.substr(start, end - start);
+        start = end + 1;
+        if (segment.empty()) continue;
+
+        // 已经保留整个子树时无需继续细分
+        if (entries[node].keepAll) return *this;
+
+        uint32_t next = NotFound;
+        for (uint32_t child : entries[node].children) {
+            if (entries[child].name == segment) {
+                next = child;
+                break;
+            }
+        }
+        if (next == NotFound) {
+            next = static_cast<uint32_t>(entries.size());
+            Entry entry;
+            entry.name = std::string(segment);
+            entries.push_back(std::move(entry));
+            entries[node].children.push_back(next);
+        }
+        node = next;
+    }
+    if (node != Root) {
+        entries[node].keepAll = true;
+        entries[node].children.clear();
+    }
+    return *this;
+}
+
+uint32_t NbtSchema::Find(uint32_t node, std::string_view name) const {
+    if (node == KeepAll) return KeepAll;
+    for (uint32_t child : entries[node].children) {
+        if (entries[child].name == name) {
+            return entries[child].keepAll ? KeepAll : child;
+        }
+    }
+    return NotFound;
+}
+
+// --------------------------------------------------------------------------------
+// NbtDocument
+// --------------------------------------------------------------------------------
+void NbtDocument::clear() {
+    buffer = nullptr;
+    bufferSize = 0;
+    pos = 0;
+    nodes.clear();
+    childRefs.clear();
+    scratch.clear();
+}
+
+void NbtDocument::Need(size_t bytes, const char* what) const {
+    if (bytes > bufferSize - pos) {
+        throw std::out_of_range(std::string("Not enough data for ") + what);
+    }
+}
+
+uint16_t NbtDocument::ReadU16() {
+    const unsigned char* p = reinterpret_cast<const unsigned char*>(buffer + pos);
+    pos += 2;
+    return static_cast<uint16_t>((p[0] << 8) | p[1]);
+}
+
+int32_t NbtDocument::ReadI32() {
+    const unsigned char* p = reinterpret_cast<const unsigned char*>(buffer + pos);
+    pos += 4;
+    return static_cast<int32_t>((static_cast<uint32_t>(p[0]) << 24) |
+        (static_cast<uint32_t>(p[1]) << 16) |
+        (static_cast<uint32_t>(p[2]) << 8) |
+        static_cast<uint32_t>(p[3]));
+}
+
+NbtView NbtDocument::Parse(const char* data, size_t size, const NbtSchema* schema) {
+    clear();
+    this->schema = schema;
+    buffer = data;
+    bufferSize = size;
+
+    Need(1, "root tag type");
+    TagType type = static_cast<TagType>(static_cast<uint8_t>(buffer[pos++]));
+    if (type == TagType::END) {
+        return NbtView();
+    }
+    Need(2, "root tag name length");
+    uint16_t nameLength = ReadU16();
+    Need(nameLength, "root tag name");
+    uint32_t nameOffset = static_cast<uint32_t>(pos);
+    pos += nameLength;
+
+    ParsePayload(type, nameOffset, nameLength, schema ? NbtSchema::Root : NbtSchema::KeepAll);
+    return root();
+}
+
+// 名字排序规则：先比长度再比字节，比较时多数情况只看长度
+static int CompareName(const char* a, size_t aLength, const char* b, size_t bLength) {
+    if (aLength != bLength) return aLength < bLength ? -1 : 1;
+    return std::memcmp(a, b, aLength);
+}
+
+void NbtDocument::FinishContainer(uint32_t nodeIndex, size_t scratchBase, bool buildNameIndex) {
+    NbtNode& node = nodes[nodeIndex];
+    node.firstChild = static_cast<uint32_t>(childRefs.size());
+    node.length = static_cast<uint32_t>(scratch.size() - scratchBase);
+    childRefs.insert(childRefs.end(), scratch.begin() + scratchBase, scratch.end());
+
+    if (buildNameIndex) {
+        // 紧跟在原顺序之后存放排序下标，稳定排序保证重名时仍返回第一个
+        size_t indexBegin = childRefs.size();
+        childRefs.insert(childRefs.end(), scratch.begin() + scratchBase, scratch.end());
+        auto nameLess = [this](uint32_t a, uint32_t b) {
+            const NbtNode& na = nodes[a];
+            const NbtNode& nb = nodes[b];
+            return CompareName(buffer + na.nameOffset, na.nameLength, buffer + nb.nameOffset, nb.nameLength) < 0;
+            };
+        auto first = childRefs.begin() + indexBegin;
+        if (node.length <= 16) {
+            // 区块中的复合标签通常只有几个子节点，插入排序不分配内存
+            for (auto it = first; it != childRefs.end(); ++it) {
+                uint32_t value = *it;
+                auto hole = it;
+                while (hole != first && nameLess(value, *(hole - 1))) {
+                    *hole = *(hole - 1);
+                    --hole;
+                }
+                *hole = value;
+            }
+        }
+        else {
+            std::stable_sort(first, childRefs.end(), nameLess);
+        }
+    }
+    scratch.resize(scratchBase);
+}
+
+void NbtDocument::SkipPayload(TagType type) {
+    NbtCursor cursor(buffer, bufferSize, pos);
+    cursor.Skip(type);
+    pos = cursor.pos;
+}
+
+uint32_t NbtDocument::ParsePayload(TagType type, uint32_t nameOffset, uint16_t nameLength, uint32_t schemaNode) {
+    uint32_t nodeIndex = static_cast<uint32_t>(nodes.size());
+    nodes.emplace_back();
+    {
+        NbtNode& node = nodes.back();
+        node.type = type;
+        node.nameOffset = nameOffset;
+        node.nameLength = nameLength;
+        node.payloadOffset = static_cast<uint32_t>(pos);
+    }
+
+    // 定长数值只需记录偏移
+    auto fixed = [&](size_t bytes, const char* what) {
+        Need(bytes, what);
+        pos += bytes;
+        };
+    // 数组记录元素数，数据保持在原缓冲区
+    auto array = [&](size_t elementSize, const char* what) {
+        Need(4, what);
+        int32_t length = ReadI32();
+        if (length < 0) throw std::runtime_error(std::string("Negative length for ") + what);
+        Need(static_cast<size_t>(length) * elementSize, what);
+        nodes[nodeIndex].payloadOffset = static_cast<uint32_t>(pos);
+        nodes[nodeIndex].length = static_cast<uint32_t>(length);
+        pos += static_cast<size_t>(length) * elementSize;
+        };
+
+    switch (type) {
+    case TagType::BYTE:   fixed(1, "TAG_Byte"); break;
+    case TagType::SHORT:  fixed(2, "TAG_Short"); break;
+    case TagType::INT:    fixed(4, "TAG_Int"); break;
+    case TagType::LONG:   fixed(8, "TAG_Long"); break;
+    case TagType::FLOAT:  fixed(4, "TAG_Float"); break;
+    case TagType::DOUBLE: fixed(8, "TAG_Double"); break;
+    case TagType::BYTE_ARRAY: array(1, "TAG_Byte_Array"); break;
+    case TagType::INT_ARRAY:  array(4, "TAG_Int_Array"); break;
+    case TagType::LONG_ARRAY: array(8, "TAG_Long_Array"); break;
+
+    case TagType::STRING: {
+        Need(2, "TAG_String length");
+        uint16_t length = ReadU16();
+        Need(length, "TAG_String");
+        nodes[nodeIndex].payloadOffset = static_cast<uint32_t>(pos);
+        nodes[nodeIndex].length = length;
+        pos += length;
+        break;
+    }
+
+    case TagType::LIST: {
+        Need(5, "TAG_List header");
+        TagType listType = static_cast<TagType>(static_cast<uint8_t>(buffer[pos++]));
+        int32_t length = ReadI32();
+        if (length < 0) throw std::runtime_error("Negative length for TAG_List");
+        if (listType == TagType::END && length > 0) {
+            throw std::runtime_error("TAG_List cannot have TAG_End elements");
+        }
+        nodes[nodeIndex].listType = listType;
+
+        size_t scratchBase = scratch.size();
+        // 列表元素没有名字，沿用列表自身的路径节点
+        for (int32_t i = 0; i < length; ++i) {
+            uint32_t childIndex = ParsePayload(listType, 0, 0, schemaNode);
+            scratch.push_back(childIndex);
+        }
+        FinishContainer(nodeIndex, scratchBase, false);
+        break;
+    }
+
+    case TagType::COMPOUND: {
+        size_t scratchBase = scratch.size();
+        while (true) {
+            Need(1, "TAG_Compound child type");
+            TagType childType = static_cast<TagType>(static_cast<uint8_t>(buffer[pos++]));
+            if (childType == TagType::END) break;
+
+            Need(2, "tag name length");
+            uint16_t childNameLength = ReadU16();
+            Need(childNameLength, "tag name");
+            uint32_t childNameOffset = static_cast<uint32_t>(pos);
+            pos += childNameLength;
+
+            uint32_t childSchema = NbtSchema::KeepAll;
+            if (schemaNode != NbtSchema::KeepAll) {
+                childSchema = schema->Find(schemaNode, std::string_view(buffer + childNameOffset, childNameLength));
+                if (childSchema == NbtSchema::NotFound) {
+                    SkipPayload(childType);
+                    continue;
+                }
+            }
+
+            uint32_t childIndex = ParsePayload(childType, childNameOffset, childNameLength, childSchema);
+            scratch.push_back(childIndex);
+        }
+        FinishContainer(nodeIndex, scratchBase, true);
+        break;
+    }
+
+    default:
+        throw std::runtime_error("Unsupported tag type: " + std::to_string(static_cast<int>(type)));
+    }
+
+    return nodeIndex;
+}
+
+// --------------------------------------------------------------------------------
+// NbtView
+// --------------------------------------------------------------------------------
+const NbtNode& NbtView::node() const {
+    return doc->nodes[index];
+}
+
+const char* NbtView::payload() const {
+    return doc->buffer + node().payloadOffset;
+}
+
+TagType NbtView::type() const {
+    return valid() ? node().type : TagType::END;
+}
+
+TagType NbtView::listType() const {
+    return valid() ? node().listType : TagType::END;
+}
+
+std::string_view NbtView::name() const {
+    if (!valid()) return {};
+    const NbtNode& n = node();
+    return std::string_view(doc->buffer + n.nameOffset, n.nameLength);
+}
+
+size_t NbtView::size() const {
+    return valid() ? node().length : 0;
+}
+
+NbtView NbtView::operator[](size_t i) const {
+    if (!valid()) return {};
+    const NbtNode& n = node();
+    if ((n.type != TagType::LIST && n.type != TagType::COMPOUND) || i >= n.length) {
+        return {};
+    }
+    return NbtView(doc, doc->childRefs[n.firstChild + i]);
+}
+
+NbtView NbtView::child(std::string_view childName) const {
+    if (!valid() || node().type != TagType::COMPOUND) return {};
+    const NbtNode& n = node();
+    const uint32_t* sorted = doc->childRefs.data() + n.firstChild + n.length;
+    size_t lo = 0;
+    size_t hi = n.length;
+    while (lo < hi) {
+        size_t mid = (lo + hi) / 2;
+        const NbtNode& c = doc->nodes[sorted[mid]];
+        if (CompareName(doc->buffer + c.nameOffset, c.nameLength, childName.data(), childName.size()) < 0) {
+            lo = mid + 1;
+        }
+        else {
+            hi = mid;
+        }
+    }
+    if (lo < n.length) {
+        const NbtNode& c = doc->nodes[sorted[lo]];
+        if (CompareName(doc->buffer + c.nameOffset, c.nameLength, childName.data(), childName.size()) == 0) {
+            return NbtView(doc, sorted[lo]);
+        }
+    }
+    return {};
+}
+
+NbtView NbtView::at(std::string_view path) const {
+    NbtView current = *this;
+    size_t start = 0;
+    while (current.valid() && start <= path.size()) {
+        size_t end = path.find('/', start);
+        if (end == std::string_view::npos) end = path.size();
+        std::string_view segment = path.substr(start, end - start);
+        start = end + 1;
+        if (segment.empty()) continue;
+
+        if (current.type() == TagType::LIST) {
+            size_t elementIndex = 0;
+            for (char c : segment) {
+                if (c < '0' || c > '9') return {};
+                elementIndex = elementIndex * 10 + static_cast<size_t>(c - '0');
+            }
+            current = current[elementIndex];
+        }
+        else {
+            current = current.child(segment);
+        }
+    }
+    return current;
+}
+
+int8_t NbtView::asByte() const {
+    return type() == TagType::BYTE ? static_cast<int8_t>(payload()[0]) : 0;
+}
+
+int16_t NbtView::asShort() const {
+    return type() == TagType::SHORT ? NbtArrayView<int16_t>(payload(), 1)[0] : 0;
+}
+
+int32_t NbtView::asInt() const {
+    return type() == TagType::INT ? NbtArrayView<int32_t>(payload(), 1)[0] : 0;
+}
+
+int64_t NbtView::asLong() const {
+    return type() == TagType::LONG ? NbtArrayView<int64_t>(payload(), 1)[0] : 0;
+}
+
+float NbtView::asFloat() const {
+    if (type() != TagType::FLOAT) return 0.0f;
+    int32_t bits = NbtArrayView<int32_t>(payload(), 1)[0];
+    float value;
+    std::memcpy(&value, &bits, sizeof(value));
+    return value;
+}
+
+double NbtView::asDouble() const {
+    if (type() != TagType::DOUBLE) return 0.0;
+    int64_t bits = NbtArrayView<int64_t>(payload(), 1)[0];
+    double value;
+    std::memcpy(&value, &bits, sizeof(value));
+    return value;
+}
+
+std::string_view NbtView::asString() const {
+    if (type() != TagType::STRING) return {};
+    return std::string_view(payload(), node().length);
+}
+
+NbtArrayView<int8_t> NbtView::asByteArray() const {
+    if (type() != TagType::BYTE_ARRAY) return {};
+    return NbtArrayView<int8_t>(payload(), node().length);
+}
+
+NbtArrayView<int32_t> NbtView::asIntArray() const {
+    if (type() != TagType::INT_ARRAY) return {};
+    return NbtArrayView<int32_t>(payload(), node().length);
+}
+
+NbtArrayView<int64_t> NbtView::asLongArray() const {
+    if (type() != TagType::LONG_ARRAY) return {};
+    return NbtArrayView<int64_t>(payload(), node().length);
+}
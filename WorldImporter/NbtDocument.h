@@ -0,0 +1,135 @@
+// NbtDocument.h
+#ifndef NBT_DOCUMENT_H
+#define NBT_DOCUMENT_H
+
+#include "NbtVisitor.h"
+#include <string>
+#include <string_view>
+#include <vector>
+#include <cstdint>
+
+// 文档中的一个标签节点，名称与负载都以偏移形式引用源缓冲区
+struct NbtNode {
+    TagType type = TagType::END;
+    TagType listType = TagType::END;  // LIST 元素类型
+    uint16_t nameLength = 0;
+    uint32_t nameOffset = 0;
+    uint32_t payloadOffset = 0;       // 数值、字符串、数组数据在缓冲区中的偏移
+    uint32_t length = 0;              // 字符串字节数、数组元素数或子节点数
+    uint32_t firstChild = 0;          // 容器：子节点在 childRefs 中的起始位置
+                                      // COMPOUND 随后还有 length 个按名字排序的下标
+};
+
+// 选择性解析的路径表：只构建注册路径上的节点，其余子树按长度跳过
+// 路径以 '/' 分隔，经过 LIST 时作用于每个元素，例如 "sections/block_states"
+// 注册路径的末端节点连同整个子树都会保留
+class NbtSchema {
+public:
+    NbtSchema();
+
+    NbtSchema& Add(std::string_view path);
+
+    static constexpr uint32_t KeepAll = 0xFFFFFFFFu;
+    static constexpr uint32_t Root = 0;
+    static constexpr uint32_t NotFound = 0xFFFFFFFEu;
+
+    // 在 node 下查找名为 name 的子路径，返回子路径节点、KeepAll 或 NotFound
+    uint32_t Find(uint32_t node, std::string_view name) const;
+
+private:
+    struct Entry {
+        std::string name;
+        bool keepAll = false;
+        std::vector<uint32_t> children;
+    };
+    std::vector<Entry> entries;
+};
+
+class NbtDocument;
+
+// 节点句柄（文档指针 + 节点下标），可按值传递
+class NbtView {
+public:
+    NbtView() = default;
+    NbtView(const NbtDocument* doc, uint32_t index) : doc(doc), index(index) {}
+
+    bool valid() const { return doc != nullptr; }
+    explicit operator bool() const { return valid(); }
+
+    TagType type() const;
+    TagType listType() const;
+    std::string_view name() const;
+
+    // LIST/COMPOUND 的子节点数，数组的元素数，字符串的字节数
+    size_t size() const;
+    // LIST/COMPOUND 的第 i 个子节点
+    NbtView operator[](size_t i) const;
+    // COMPOUND 中名字匹配的子节点，不存在时返回无效视图
+    // 使用按名字排序的下标二分查找
+    NbtView child(std::string_view childName) const;
+    // 按路径一次解析，例如 at("block_states/palette") 或 at("sections/0/Y")
+    // LIST 上的数字段表示元素下标，任一段不存在时返回无效视图
+    NbtView at(std::string_view path) const;
+
+    int8_t asByte() const;
+    int16_t asShort() const;
+    int32_t asInt() const;
+    int64_t asLong() const;
+    float asFloat() const;
+    double asDouble() const;
+    std::string_view asString() const;
+    NbtArrayView<int8_t> asByteArray() const;
+    NbtArrayView<int32_t> asIntArray() const;
+    NbtArrayView<int64_t> asLongArray() const;
+
+private:
+    const NbtNode& node() const;
+    const char* payload() const;
+
+    const NbtDocument* doc = nullptr;
+    uint32_t index = 0;
+};
+
+// 基于视图的 NBT 文档：所有节点存放在连续数组中，名称和数组直接引用源缓冲区，
+// 解析过程中不为单个标签分配堆内存。文档可复用，clear 后保留容量
+class NbtDocument {
+public:
+    // 解析 data 中的根标签，返回根节点；data 必须在文档使用期间保持有效
+    // 数据不完整或格式错误时抛出异常（与 readTag 一致）
+    // schema 不为空时只保留其中注册的路径
+    NbtView Parse(const char* data, size_t size, const NbtSchema* schema = nullptr);
+    NbtView Parse(const std::vector<char>& data, const NbtSchema* schema = nullptr) {
+        return Parse(data.data(), data.size(), schema);
+    }
+    // 接管解压后的缓冲区，文档自身保证数据的生命周期
+    NbtView Parse(std::vector<char>&& data, const NbtSchema* schema = nullptr) {
+        storage = std::move(data);
+        return Parse(storage.data(), storage.size(), schema);
+    }
+
+    NbtView root() const { return nodes.empty() ? NbtView() : NbtView(this, 0); }
+    size_t nodeCount() const { return nodes.size(); }
+    void clear();
+
+private:
+    friend class NbtView;
+
+    uint32_t ParsePayload(TagType type, uint32_t nameOffset, uint16_t nameLength, uint32_t schemaNode);
+    void SkipPayload(TagType type);
+    void FinishContainer(uint32_t nodeIndex, size_t scratchBase, bool buildNameIndex);
+    void Need(size_t bytes, const char* what) const;
+    uint16_t ReadU16();
+    int32_t ReadI32();
+
+    const NbtSchema* schema = nullptr;
+    std::vector<char> storage;        // Parse(std::vector<char>&&) 接管的缓冲区
+    const char* buffer = nullptr;
+    size_t bufferSize = 0;
+    size_t pos = 0;
+
+    std::vector<NbtNode> nodes;
+    std::vector<uint32_t> childRefs;  // 各容器的子节点下标，按容器连续存放
+    std::vector<uint32_t> scratch;    // 解析时暂存子节点下标（按深度栈式使用）
+};
+
+#endif // NBT_DOCUMENT_H
@@ -0,0 +1,248 @@
+﻿#include "NbtVisitor.h"
+#include <stdexcept>
+#include <string>
+#include <cstring>
+
+// --------------------------------------------------------------------------------
+// NbtCursor
+// --------------------------------------------------------------------------------
+void NbtCursor::Need(size_t bytes, const char* what) const {
+    if (bytes > size - pos) {
+        throw std::out_of_range(std::string("Not enough data for ") + what);
+    }
+}
+
+uint16_t NbtCursor::ReadU16() {
+    const unsigned char* p = reinterpret_cast<const unsigned char*>(data + pos);
+    pos += 2;
+    return static_cast<uint16_t>((p[0] << 8) | p[1]);
+}
+
+int32_t NbtCursor::ReadI32() {
+    const unsigned char* p = reinterpret_cast<const unsigned char*>(data + pos);
+    pos += 4;
+    return static_cast<int32_t>((static_cast<uint32_t>(p[0]) << 24) |
+        (static_cast<uint32_t>(p[1]) << 16) |
+        (static_cast<uint32_t>(p[2]) << 8) |
+        static_cast<uint32_t>(p[3]));
+}
+
+void NbtCursor::Skip(TagType type) {
+    // 跳过一个标签负载而不回调，列表与复合标签逐层按长度跳过
+    auto skipArray = [&](size_t elementSize, const char* what) {
+        Need(4, what);
+        int32_t length = ReadI32();
+        if (length < 0) throw std::runtime_error(std::string("Negative length for ") + what);
+        Need(static_cast<size_t>(length) * elementSize, what);
+        pos += static_cast<size_t>(length) * elementSize;
+        };
+
+    switch (type) {
+    case TagType::BYTE:   Need(1, "TAG_Byte"); pos += 1; break;
+    case TagType::SHORT:  Need(2, "TAG_Short"); pos += 2; break;
+    case TagType::INT:    Need(4, "TAG_Int"); pos += 4; break;
+    case TagType::LONG:   Need(8, "TAG_Long"); pos += 8; break;
+    case TagType::FLOAT:  Need(4, "TAG_Float"); pos += 4; break;
+    case TagType::DOUBLE: Need(8, "TAG_Double"); pos += 8; break;
+    case TagType::BYTE_ARRAY: skipArray(1, "TAG_Byte_Array"); break;
+    case TagType::INT_ARRAY:  skipArray(4, "TAG_Int_Array"); break;
+    case TagType::LONG_ARRAY: skipArray(8, "TAG_Long_Array"); break;
+
+    case TagType::STRING: {
+        Need(2, "TAG_String length");
+        uint16_t length = ReadU16();
+        Need(length, "TAG_String");
+        pos += length;
+        break;
+    }
+
+    case TagType::LIST: {
+        Need(5, "TAG_List header");
+        TagType listType = static_cast<TagType>(static_cast<uint8_t>(data[pos++]));
+        int32_t length = ReadI32();
+        if (length < 0) throw std::runtime_error("Negative length for TAG_List");
+        if (listType == TagType::END && length > 0) {
+            throw std::runtime_error("TAG_List cannot have TAG_End elements");
+        }
+
+        // 定长元素一次跳过，其余（字符串、数组、列表、复合标签）逐个跳过
+        size_t fixedSize = 0;
+        switch (listType) {
+        case TagType::BYTE: fixedSize = 1; break;
+        case TagType::SHORT: fixedSize = 2; break;
+        case TagType::INT: case TagType::FLOAT: fixedSize = 4; break;
+        case TagType::LONG: case TagType::DOUBLE: fixedSize = 8; break;
+        default: break;
+        }
+        if (fixedSize > 0) {
+            Need(static_cast<size_t>(length) * fixedSize, "TAG_List payload");
+            pos += static_cast<size_t>(length) * fixedSize;
+        }
+        else {
+            for (int32_t i = 0; i < length; ++i) {
+                Skip(listType);
+            }
+        }
+        break;
+    }
+
+    case TagType::COMPOUND: {
+        while (true) {
+            Need(1, "TAG_Compound child type");
+            TagType childType = static_cast<TagType>(static_cast<uint8_t>(data[pos++]));
+            if (childType == TagType::END) break;
+            Need(2, "tag name length");
+            uint16_t childNameLength = ReadU16();
+            Need(childNameLength, "tag name");
+            pos += childNameLength;
+            Skip(childType);
+        }
+        break;
+    }
+
+    default:
+        throw std::runtime_error("Unsupported tag type: " + std::to_string(static_cast<int>(type)));
+    }
+}
+
+// --------------------------------------------------------------------------------
+// VisitNbt
+// --------------------------------------------------------------------------------
+namespace {
+    using Action = NbtVisitor::Action;
+
+    // 递归解析并回调 visitor，返回 false 表示 visitor 要求停止
+    class NbtWalker {
+    public:
+        NbtWalker(const char* data, size_t size, NbtVisitor& visitor) : cursor(data, size), visitor(visitor) {}
+
+        bool VisitRoot() {
+            cursor.Need(1, "root tag type");
+            TagType type = static_cast<TagType>(cursor.ReadU8());
+            if (type == TagType::END) {
+                return true;
+            }
+            return VisitPayload(type, ReadName("root tag name"));
+        }
+
+    private:
+        std::string_view ReadName(const char* what) {
+            cursor.Need(2, what);
+            uint16_t length = cursor.ReadU16();
+            cursor.Need(length, what);
+            std::string_view name(cursor.data + cursor.pos, length);
+            cursor.pos += length;
+            return name;
+        }
+
+        template <typename T>
+        T ReadScalar(const char* what) {
+            cursor.Need(sizeof(T), what);
+            T value = NbtArrayView<T>(cursor.data + cursor.pos, 1)[0];
+            cursor.pos += sizeof(T);
+            return value;
+        }
+
+        template <typename T>
+        NbtArrayView<T> ReadArray(const char* what) {
+            cursor.Need(4, what);
+            int32_t length = cursor.ReadI32();
+            if (length < 0) throw std::runtime_error(std::string("Negative length for ") + what);
+            cursor.Need(static_cast<size_t>(length) * sizeof(T), what);
+            NbtArrayView<T> values(cursor.data + cursor.pos, static_cast<size_t>(length));
+            cursor.pos += static_cast<size_t>(length) * sizeof(T);
+            return values;
+        }
+
+        bool VisitPayload(TagType type, std::string_view name) {
+            switch (type) {
+            case TagType::BYTE:
+                cursor.Need(1, "TAG_Byte");
+                return visitor.onByte(name, static_cast<int8_t>(cursor.ReadU8())) != Action::Stop;
+            case TagType::SHORT:
+                return visitor.onShort(name, ReadScalar<int16_t>("TAG_Short")) != Action::Stop;
+            case TagType::INT:
+                return visitor.onInt(name, ReadScalar<int32_t>("TAG_Int")) != Action::Stop;
+            case TagType::LONG:
+                return visitor.onLong(name, ReadScalar<int64_t>("TAG_Long")) != Action::Stop;
+            case TagType::FLOAT: {
+                int32_t bits = ReadScalar<int32_t>("TAG_Float");
+                float value;
+                std::memcpy(&value, &bits, sizeof(value));
+                return visitor.onFloat(name, value) != Action::Stop;
+            }
+            case TagType::DOUBLE: {
+                int64_t bits = ReadScalar<int64_t>("TAG_Double");
+                double value;
+                std::memcpy(&value, &bits, sizeof(value));
+                return visitor.onDouble(name, value) != Action::Stop;
+            }
+            case TagType::STRING: {
+                cursor.Need(2, "TAG_String length");
+                uint16_t length = cursor.ReadU16();
+                cursor.Need(length, "TAG_String");
+                std::string_view value(cursor.data + cursor.pos, length);
+                cursor.pos += length;
+                return visitor.onString(name, value) != Action::Stop;
+            }
+            case TagType::BYTE_ARRAY:
+                return visitor.onByteArray(name, ReadArray<int8_t>("TAG_Byte_Array")) != Action::Stop;
+            case TagType::INT_ARRAY:
+                return visitor.onIntArray(name, ReadArray<int32_t>("TAG_Int_Array")) != Action::Stop;
+            case TagType::LONG_ARRAY:
+                return visitor.onLongArray(name, ReadArray<int64_t>("TAG_Long_Array")) != Action::Stop;
+
+            case TagType::LIST: {
+                size_t listStart = cursor.pos;
+                cursor.Need(5, "TAG_List header");
+                TagType listType = static_cast<TagType>(cursor.ReadU8());
+                int32_t length = cursor.ReadI32();
+                if (length < 0) throw std::runtime_error("Negative length for TAG_List");
+                if (listType == TagType::END && length > 0) {
+                    throw std::runtime_error("TAG_List cannot have TAG_End elements");
+                }
+
+                Action action = visitor.onListBegin(name, listType, static_cast<size_t>(length));
+                if (action == Action::Stop) return false;
+                if (action == Action::Skip) {
+                    cursor.pos = listStart;
+                    cursor.Skip(TagType::LIST);
+                    return true;
+                }
+                for (int32_t i = 0; i < length; ++i) {
+                    if (!VisitPayload(listType, std::string_view())) return false;
+                }
+                return visitor.onListEnd() != Action::Stop;
+            }
+
+            case TagType::COMPOUND: {
+                Action action = visitor.onCompoundBegin(name);
+                if (action == Action::Stop) return false;
+                if (action == Action::Skip) {
+                    cursor.Skip(TagType::COMPOUND);
+                    return true;
+                }
+                while (true) {
+                    cursor.Need(1, "TAG_Compound child type");
+                    TagType childType = static_cast<TagType>(cursor.ReadU8());
+                    if (childType == TagType::END) break;
+                    std::string_view childName = ReadName("tag name");
+                    if (!VisitPayload(childType, childName)) return false;
+                }
+                return visitor.onCompoundEnd() != Action::Stop;
+            }
+
+            default:
+                throw std::runtime_error("Unsupported tag type: " + std::to_string(static_cast<int>(type)));
+            }
+        }
+
+        NbtCursor cursor;
+        NbtVisitor& visitor;
+    };
+}
+
+bool VisitNbt(const char* data, size_t size, NbtVisitor& visitor) {
+    NbtWalker walker(data, size, visitor);
+    return walker.VisitRoot();
+}
@@ -0,0 +1,116 @@
+// NbtVisitor.h
+#ifndef NBT_VISITOR_H
+#define NBT_VISITOR_H
+
+#include "nbtutils.h"
+#include "byteswap.h"
+#include <string_view>
+#include <cstring>
+#include <type_traits>
+#include <cstddef>
+#include <cstdint>
+
+// 大端数值数组视图：直接指向解压缓冲区，读取元素时才转换字节序
+template <typename T>
+class NbtArrayView {
+public:
+    NbtArrayView() = default;
+    NbtArrayView(const char* bytes, size_t count) : bytes(bytes), count(count) {}
+
+    size_t size() const { return count; }
+    bool empty() const { return count == 0; }
+    // 原始大端字节
+    const char* data() const { return bytes; }
+
+    T operator[](size_t i) const {
+        // 按无符号类型交换，避免有符号右移带来的符号扩展
+        using U = std::make_unsigned_t<T>;
+        U bits;
+        std::memcpy(&bits, bytes + i * sizeof(T), sizeof(T));
+        if constexpr (sizeof(T) > 1) {
+            bits = byteSwap(bits);
+        }
+        T value;
+        std::memcpy(&value, &bits, sizeof(T));
+        return value;
+    }
+
+    // 整个数组一次性转换为主机字节序写入 out（至少 size() 个元素）
+    void copyToHost(T* out) const {
+        if constexpr (sizeof(T) == 8) {
+            ByteSwapArray64(bytes, out, count);
+        }
+        else if constexpr (sizeof(T) == 4) {
+            ByteSwapArray32(bytes, out, count);
+        }
+        else {
+            for (size_t i = 0; i < count; ++i) out[i] = (*this)[i];
+        }
+    }
+
+    // 转换到主机字节序缓冲（如 HostLongBuffer），缓冲调整为 size() 个元素
+    template <typename Buffer>
+    void toHost(Buffer& out) const {
+        static_assert(sizeof(typename Buffer::value_type) == sizeof(T), "element size mismatch");
+        out.resize(count);
+        copyToHost(reinterpret_cast<T*>(out.data()));
+    }
+
+private:
+    const char* bytes = nullptr;
+    size_t count = 0;
+};
+
+// 顺序读取 NBT 缓冲区的游标，越界时抛出 std::out_of_range
+struct NbtCursor {
+    const char* data = nullptr;
+    size_t size = 0;
+    size_t pos = 0;
+
+    NbtCursor(const char* data, size_t size, size_t pos = 0) : data(data), size(size), pos(pos) {}
+
+    void Need(size_t bytes, const char* what) const;
+    uint8_t ReadU8() { return static_cast<uint8_t>(data[pos++]); }
+    uint16_t ReadU16();
+    int32_t ReadI32();
+    // 跳过一个 type 类型标签的负载而不回调，列表与复合标签逐层按长度跳过
+    void Skip(TagType type);
+};
+
+// 事件驱动（SAX 风格）的 NBT 访问接口：VisitNbt 直接在缓冲区上顺序解析，
+// 每遇到一个标签回调一次，不构建任何节点。name 对列表元素为空，
+// 字符串和数组以视图形式给出，只在 VisitNbt 调用期间有效
+class NbtVisitor {
+public:
+    enum class Action {
+        Continue,  // 继续遍历（对 Begin 回调表示进入容器）
+        Skip,      // 仅对 Begin 回调有效：按长度跳过整个容器，不再回调其 End
+        Stop       // 立即结束遍历
+    };
+
+    virtual ~NbtVisitor() = default;
+
+    virtual Action onCompoundBegin(std::string_view /*name*/) { return Action::Continue; }
+    virtual Action onCompoundEnd() { return Action::Continue; }
+    virtual Action onListBegin(std::string_view /*name*/, TagType /*elementType*/, size_t /*length*/) { return Action::Continue; }
+    virtual Action onListEnd() { return Action::Continue; }
+
+    virtual Action onByte(std::string_view /*name*/, int8_t /*value*/) { return Action::Continue; }
+    virtual Action onShort(std::string_view /*name*/, int16_t /*value*/) { return Action::Continue; }
+    virtual Action onInt(std::string_view /*name*/, int32_t /*value*/) { return Action::Continue; }
+    virtual Action onLong(std::string_view /*name*/, int64_t /*value*/) { return Action::Continue; }
+    virtual Action onFloat(std::string_view /*name*/, float /*value*/) { return Action::Continue; }
+    virtual Action onDouble(std::string_view /*name*/, double /*value*/) { return Action::Continue; }
+    virtual Action onString(std::string_view /*name*/, std::string_view /*value*/) { return Action::Continue; }
+
+    virtual Action onByteArray(std::string_view /*name*/, NbtArrayView<int8_t> /*values*/) { return Action::Continue; }
+    virtual Action onIntArray(std::string_view /*name*/, NbtArrayView<int32_t> /*values*/) { return Action::Continue; }
+    virtual Action onLongArray(std::string_view /*name*/, NbtArrayView<int64_t> /*values*/) { return Action::Continue; }
+};
+
+// 用 visitor 遍历 data 中的根标签
+// 正常结束返回 true，visitor 返回 Stop 时提前结束并返回 false
+// 数据不完整或格式错误时抛出异常（与 readTag 一致）
+bool VisitNbt(const char* data, size_t size, NbtVisitor& visitor);
+
+#endif // NBT_VISITOR_H
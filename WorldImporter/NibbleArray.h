@@ -0,0 +1,38 @@
+// NibbleArray.h
+#ifndef NIBBLE_ARRAY_H
+#define NIBBLE_ARRAY_H
+
+#include <vector>
+#include <algorithm>
+#include <cstring>
+#include <cstddef>
+#include <cstdint>
+
+// 4096 个 4 位数值（子区块光照），保持存档中的 2048 字节格式：
+// 下标 yzx 的数值位于第 yzx/2 个字节，偶数下标取低 4 位，奇数下标取高 4 位
+class NibbleArray {
+public:
+    static constexpr size_t ByteSize = 2048;
+
+    bool empty() const { return bytes.empty(); }
+
+    // 复制原始数据，不足 2048 字节的部分补 0
+    void Assign(const char* data, size_t size) {
+        bytes.assign(ByteSize, 0);
+        std::memcpy(bytes.data(), data, std::min(size, ByteSize));
+    }
+
+    void clear() { bytes.clear(); bytes.shrink_to_fit(); }
+
+    int Get(int yzx) const {
+        uint8_t value = bytes[static_cast<size_t>(yzx) >> 1];
+        return (yzx & 1) ? (value >> 4) : (value & 0xF);
+    }
+
+    size_t MemoryBytes() const { return bytes.capacity(); }
+
+private:
+    std::vector<uint8_t> bytes;
+};
+
+#endif // NIBBLE_ARRAY_H
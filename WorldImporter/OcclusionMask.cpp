@@ -0,0 +1,40 @@
+﻿#include "OcclusionMask.h"
+
+namespace {
+    // 每行 x = 0 与 x = 15 所在的位
+    constexpr uint64_t RowFirstX = 0x0001000100010001ull;
+    constexpr uint64_t RowLastX = 0x8000800080008000ull;
+    // 字内第一行（z % 4 == 0）与最后一行（z % 4 == 3）
+    constexpr uint64_t FirstRow = 0x000000000000FFFFull;
+    constexpr uint64_t LastRow = 0xFFFF000000000000ull;
+}
+
+void ComputeCoveredFaces(const OcclusionMask& center, const OcclusionMask neighbors[6], OcclusionMask covered[6]) {
+    const auto& c = center.words;
+    for (int w = 0; w < 64; ++w) {
+        const int y = w >> 2;
+        const int zGroup = w & 3;
+
+        // 上下：相邻 y 层的同一个字，越界时取上下子区块的边界层
+        covered[FACE_UP].words[w] = (y < 15) ? c[w + 4] : neighbors[FACE_UP].words[w - 60];
+        covered[FACE_DOWN].words[w] = (y > 0) ? c[w - 4] : neighbors[FACE_DOWN].words[w + 60];
+
+        // 东西：行内移 1 位，x = 15 / x = 0 处补相邻子区块的边界列
+        covered[FACE_EAST].words[w] = ((c[w] >> 1) & ~RowLastX) | ((neighbors[FACE_EAST].words[w] & RowFirstX) << 15);
+        covered[FACE_WEST].words[w] = ((c[w] << 1) & ~RowFirstX) | ((neighbors[FACE_WEST].words[w] & RowLastX) >> 15);
+
+        // 南北：行间移 16 位，跨字时取相邻字，z = 15 / z = 0 处补相邻子区块的边界行
+        uint64_t southNext = (zGroup < 3) ? c[w + 1] : neighbors[FACE_SOUTH].words[w - 3];
+        uint64_t northPrev = (zGroup > 0) ? c[w - 1] : neighbors[FACE_NORTH].words[w + 3];
+        covered[FACE_SOUTH].words[w] = (c[w] >> 16) | ((southNext & FirstRow) << 48);
+        covered[FACE_NORTH].words[w] = (c[w] << 16) | ((northPrev & LastRow) >> 48);
+    }
+}
+
+void ComputeHiddenBlocks(const OcclusionMask& center, const OcclusionMask covered[6], OcclusionMask& hidden) {
+    for (int w = 0; w < 64; ++w) {
+        hidden.words[w] = center.words[w] &
+            covered[0].words[w] & covered[1].words[w] & covered[2].words[w] &
+            covered[3].words[w] & covered[4].words[w] & covered[5].words[w];
+    }
+}
@@ -0,0 +1,47 @@
+// OcclusionMask.h
+#ifndef OCCLUSION_MASK_H
+#define OCCLUSION_MASK_H
+
+#include "FaceDirection.h"
+#include <array>
+#include <cstdint>
+#if defined(_MSC_VER)
+#include <intrin.h>
+#endif
+
+// 非零 64 位整数最低位 1 的位置
+inline int CountTrailingZeros(uint64_t value) {
+#if defined(_MSC_VER)
+    unsigned long index;
+    _BitScanForward64(&index, value);
+    return static_cast<int>(index);
+#else
+    return __builtin_ctzll(value);
+#endif
+}
+
+// 子区块 4096 个方块的位集，第 yzx 位对应 toYZX(x, y, z)
+// 每个 64 位字存放同一 y 层的 4 行 z，每行 16 个 x（字下标 = y * 4 + z / 4，位 = (z % 4) * 16 + x）
+struct OcclusionMask {
+    std::array<uint64_t, 64> words{};
+
+    bool Test(int yzx) const { return (words[yzx >> 6] >> (yzx & 63)) & 1; }
+    void Set(int yzx) { words[yzx >> 6] |= static_cast<uint64_t>(1) << (yzx & 63); }
+    void Fill(bool value) { words.fill(value ? ~static_cast<uint64_t>(0) : 0); }
+
+    bool Any() const {
+        for (uint64_t word : words) {
+            if (word) return true;
+        }
+        return false;
+    }
+};
+
+// 由中心子区块与六个相邻子区块的不透明位集，按移位与按位与计算各方向的遮挡：
+// covered[d] 的第 yzx 位表示该方块在方向 d 上紧邻的方块不透明（该方向的面被遮挡）
+void ComputeCoveredFaces(const OcclusionMask& center, const OcclusionMask neighbors[6], OcclusionMask covered[6]);
+
+// 不透明且六个方向都被遮挡的方块
+void ComputeHiddenBlocks(const OcclusionMask& center, const OcclusionMask covered[6], OcclusionMask& hidden);
+
+#endif // OCCLUSION_MASK_H
@@ -0,0 +1,39 @@
+﻿#include "PalettedContainer.h"
+#include <algorithm>
+
+PalettedContainer::PalettedContainer(int globalId) : palette(1, globalId) {}
+
+PalettedContainer::PalettedContainer(const std::vector<int>& localToGlobal, const uint64_t* words, size_t wordCount, int bits) {
+    if (localToGlobal.size() <= 1 || bits < 1 || bits > 16) {
+        // 只有一种方块（或位宽无效）时不保存下标
+        palette.assign(1, localToGlobal.empty() ? 0 : localToGlobal[0]);
+        return;
+    }
+
+    this->bits = static_cast<uint8_t>(bits);
+    perLong = static_cast<uint8_t>(64 / bits);
+    divMagic = static_cast<uint32_t>((static_cast<uint64_t>(1) << 32) / perLong + 1);
+
+    size_t needed = (SectionVolume + perLong - 1) / perLong;
+    this->words.assign(needed, 0);
+    std::copy(words, words + std::min(wordCount, needed), this->words.begin());
+
+    palette.assign(static_cast<size_t>(1) << bits, 0);
+    std::copy(localToGlobal.begin(), localToGlobal.begin() + std::min(localToGlobal.size(), palette.size()), palette.begin());
+}
+
+void PalettedContainer::Unpack(int* out) const {
+    if (bits == 0) {
+        std::fill(out, out + SectionVolume, UniformId());
+        return;
+    }
+    uint16_t indices[SectionVolume];
+    UnpackPaletteIndices(words.data(), words.size(), bits, indices);
+    for (int i = 0; i < SectionVolume; ++i) {
+        out[i] = palette[indices[i]];
+    }
+}
+
+size_t PalettedContainer::MemoryBytes() const {
+    return sizeof(PalettedContainer) + palette.capacity() * sizeof(int) + words.capacity() * sizeof(uint64_t);
+}
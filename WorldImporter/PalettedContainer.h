@@ -0,0 +1,60 @@
+// PalettedContainer.h
+#ifndef PALETTED_CONTAINER_H
+#define PALETTED_CONTAINER_H
+
+#include "bitunpack.h"
+#include <vector>
+#include <cstddef>
+#include <cstdint>
+
+// 子区块方块存储，仿照 Minecraft 自身格式：局部→全局ID表 + 位压缩下标
+// 下标直接沿用区块 block_states/data 的 long 数组（每条目 bits 位，条目不跨 long），
+// 常见的 4 位子区块只占 2 KiB，而展开为 4096 个 int 需要 16 KiB
+class PalettedContainer {
+public:
+    // 空容器：子区块不存在，所有方块视为 0（空气）
+    PalettedContainer() = default;
+
+    // 整个子区块为同一种方块
+    explicit PalettedContainer(int globalId);
+
+    // localToGlobal 为局部调色板到全局ID的映射，words 为主机字节序的 data 数组
+    // words 不足时缺少的下标视为 0，超出调色板的下标返回 0（空气）
+    PalettedContainer(const std::vector<int>& localToGlobal, const uint64_t* words, size_t wordCount, int bits);
+
+    // 子区块不存在
+    bool empty() const { return palette.empty(); }
+    // 只含一种方块（包括不存在的子区块）
+    bool IsUniform() const { return bits == 0; }
+    // 均匀子区块的方块ID
+    int UniformId() const { return palette.empty() ? 0 : palette[0]; }
+    // 局部→全局ID表（补齐的项可能重复）
+    const std::vector<int>& Palette() const { return palette; }
+
+    // O(1) 读取 yzx 处的全局ID
+    int Get(int yzx) const {
+        if (bits == 0) {
+            return UniformId();
+        }
+        // 乘以预先算好的倒数代替除法，yzx < 4096 时结果精确
+        uint32_t wordIndex = static_cast<uint32_t>((static_cast<uint64_t>(yzx) * divMagic) >> 32);
+        uint32_t slot = static_cast<uint32_t>(yzx) - wordIndex * perLong;
+        uint64_t index = (words[wordIndex] >> (slot * bits)) & ((static_cast<uint64_t>(1) << bits) - 1);
+        return palette[static_cast<size_t>(index)];
+    }
+
+    // 批量解包为 4096 个全局ID
+    void Unpack(int* out) const;
+
+    // 估算占用内存（字节）
+    size_t MemoryBytes() const;
+
+private:
+    std::vector<int> palette;     // 局部→全局ID，补齐到 2^bits 项使 Get 无需越界判断
+    std::vector<uint64_t> words;  // 位压缩的局部下标
+    uint8_t bits = 0;             // 每条目位数，0 表示均匀子区块
+    uint8_t perLong = 0;          // 每个 long 存放的条目数
+    uint32_t divMagic = 0;        // ceil(2^32 / perLong)
+};
+
+#endif // PALETTED_CONTAINER_H
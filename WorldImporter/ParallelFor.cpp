@@ -0,0 +1,102 @@
+﻿#include "ParallelFor.h"
+#include <algorithm>
+#include <exception>
+#include <future>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace {
+    // 每个线程待处理的下标区间，所有者从头部取，窃取者从尾部取
+    struct WorkRange {
+        std::mutex mutex;
+        size_t begin = 0;
+        size_t end = 0;
+    };
+}
+
+void ParallelFor(size_t count, const std::function<void(size_t)>& body, size_t threadCount) {
+    if (threadCount == 0) {
+        threadCount = std::max<unsigned>(1, std::thread::hardware_concurrency());
+    }
+    threadCount = std::min(threadCount, count);
+    if (threadCount <= 1) {
+        for (size_t i = 0; i < count; ++i) {
+            body(i);
+        }
+        return;
+    }
+
+    std::unique_ptr<WorkRange[]> ranges(new WorkRange[threadCount]);
+    for (size_t t = 0; t < threadCount; ++t) {
+        ranges[t].begin = count * t / threadCount;
+        ranges[t].end = count * (t + 1) / threadCount;
+    }
+
+    auto worker = [&ranges, &body, threadCount](size_t self) {
+        while (true) {
+            size_t task = 0;
+            bool found = false;
+            {
+                std::lock_guard<std::mutex> lock(ranges[self].mutex);
+                if (ranges[self].begin < ranges[self].end) {
+                    task = ranges[self].begin++;
+                    found = true;
+                }
+            }
+
+            if (!found) {
+                // 自己的区间已空，依次尝试从其他线程窃取剩余任务的后一半
+                for (size_t k = 1; k < threadCount && !found; ++k) {
+                    WorkRange& victim = ranges[(self + k) % threadCount];
+                    size_t stolenBegin = 0, stolenEnd = 0;
+                    {
+                        std::lock_guard<std::mutex> lock(victim.mutex);
+                        size_t remaining = victim.end - victim.begin;
+                        if (remaining == 0) continue;
+                        stolenEnd = victim.end;
+                        stolenBegin = victim.end - (remaining + 1) / 2;
+                        victim.end = stolenBegin;
+                    }
+                    task = stolenBegin;
+                    found = true;
+                    std::lock_guard<std::mutex> lock(ranges[self].mutex);
+                    ranges[self].begin = stolenBegin + 1;
+                    ranges[self].end = stolenEnd;
+                }
+                if (!found) {
+                    return;
+                }
+            }
+
+            body(task);
+        }
+        };
+
+    std::vector<std::future<void>> futures;
+    futures.reserve(threadCount - 1);
+    for (size_t t = 1; t < threadCount; ++t) {
+        futures.emplace_back(std::async(std::launch::async, worker, t));
+    }
+
+    // 当前线程也参与计算
+    std::exception_ptr error;
+    try {
+        worker(0);
+    }
+    catch (...) {
+        error = std::current_exception();
+    }
+    for (auto& f : futures) {
+        try {
+            f.get();
+        }
+        catch (...) {
+            if (!error) error = std::current_exception();
+        }
+    }
+    if (error) {
+        std::rethrow_exception(error);
+    }
+}
@@ -0,0 +1,14 @@
+// ParallelFor.h
+#ifndef PARALLEL_FOR_H
+#define PARALLEL_FOR_H
+
+#include <functional>
+#include <cstddef>
+
+// 工作窃取的并行循环：[0, count) 先按线程均分为连续区间，
+// 线程做完自己的区间后从其他线程区间的尾部窃取一半继续做。
+// body 在任意线程上以任意顺序执行，结果应按下标写入预先分配的位置以保证确定性。
+// threadCount 为 0 时使用硬件并发数；body 抛出的第一个异常在所有线程结束后重新抛出
+void ParallelFor(size_t count, const std::function<void(size_t)>& body, size_t threadCount = 0);
+
+#endif // PARALLEL_FOR_H
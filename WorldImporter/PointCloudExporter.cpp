@@ -1,9 +1,10 @@
-#include "PointCloudExporter.h"
+﻿#include "PointCloudExporter.h"
 #include "biome.h"
 #include "block.h"
 #include "model.h"
 #include "blockstate.h"
 #include "objExporter.h"
+#include "coord_conversion.h"
 #include <chrono>
 #include <sstream>
 #include <iostream>
@@ -87,20 +88,40 @@ void PointCloudExporter::PreprocessBlockModels(std::vector<Block> blockPalette)
 }
 
 void PointCloudExporter::ExportPointCloud(int xStart, int xEnd, int yStart, int yEnd, int zStart, int zEnd) {
-    // 遍历所有方块位置
-    for (int x = xStart; x <= xEnd; ++x) {
-        for (int y = yStart; y <= yEnd; ++y) {
-            for (int z = zStart; z <= zEnd; ++z) {
-                int blockId = GetBlockId(x, y, z);
-                string blockName = GetBlockNameById(blockId);
-                /*if (blockName=="minecraft:azalea_leaves[]")
-                {
-                    std::cout << blockName;
-                }*/
-                // 如果方块不是 "minecraft:air"，则导出该方块位置为点
-                if (blockName != "minecraft:air") {
-                    // 将该点作为顶点写入 .obj 文件，格式：v x y z id
-                    objFile << "v " << x << " " << y << " " << z << " " << blockId << endl;
+    // 导出范围内的子区块按坐标直接索引
+    int chunkXStart, chunkZStart, chunkXEnd, chunkZEnd, sectionYStart, sectionYEnd;
+    blockToChunk(xStart, zStart, chunkXStart, chunkZStart);
+    blockToChunk(xEnd, zEnd, chunkXEnd, chunkZEnd);
+    blockYToSectionY(yStart, sectionYStart);
+    blockYToSectionY(yEnd, sectionYEnd);
+    SetSectionCacheBounds(chunkXStart, chunkXEnd, chunkZStart, chunkZEnd, sectionYStart, sectionYEnd);
+
+    // 按子区块遍历，点云不需要邻居，直接读取中心子区块而不展开游标，
+    // 避免加载导出范围外的一圈子区块
+    for (int chunkX = chunkXStart; chunkX <= chunkXEnd; ++chunkX) {
+        for (int sectionY = sectionYStart; sectionY <= sectionYEnd; ++sectionY) {
+            for (int chunkZ = chunkZStart; chunkZ <= chunkZEnd; ++chunkZ) {
+                const PalettedContainer& blocks = AcquireSection(chunkX, chunkZ, AdjustSectionY(sectionY)).blocks;
+                // 整个子区块都是空气时跳过
+                if (blocks.IsUniform() && (GetBlockStateInfo(blocks.UniformId()).flags & BLOCK_STATE_AIR)) {
+                    continue;
+                }
+                int xMin = std::max(xStart, chunkX * 16), xMax = std::min(xEnd, chunkX * 16 + 15);
+                int yMin = std::max(yStart, sectionY * 16), yMax = std::min(yEnd, sectionY * 16 + 15);
+                int zMin = std::max(zStart, chunkZ * 16), zMax = std::min(zEnd, chunkZ * 16 + 15);
+
+                // 遍历子区块内位于导出范围的方块
+                for (int x = xMin; x <= xMax; ++x) {
+                    for (int y = yMin; y <= yMax; ++y) {
+                        for (int z = zMin; z <= zMax; ++z) {
+                            int blockId = blocks.Get(((y - sectionY * 16) * 16 + (z - chunkZ * 16)) * 16 + (x - chunkX * 16));
+                            // 如果方块不是 "minecraft:air"，则导出该方块位置为点
+                            if (!(GetBlockStateInfo(blockId).flags & BLOCK_STATE_AIR)) {
+                                // 将该点作为顶点写入 .obj 文件，格式：v x y z id
+                                objFile << "v " << x << " " << y << " " << z << " " << blockId << "\n";
+                            }
+                        }
+                    }
                 }
             }
         }
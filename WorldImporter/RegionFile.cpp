@@ -0,0 +1,236 @@
+#include "RegionFile.h"
+#include "fileutils.h"
+#include <iostream>
+#include <sstream>
+#include <algorithm>
+
+#ifdef _WIN32
+#include <windows.h>
+#else
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <fcntl.h>
+#include <unistd.h>
+#endif
+
+// --------------------------------------------------------------------------------
+// MappedFile
+// --------------------------------------------------------------------------------
+MappedFile::~MappedFile() {
+    close();
+}
+
+#ifdef _WIN32
+bool MappedFile::open(const std::string& filePath) {
+    close();
+
+    std::wstring widePath = string_to_wstring(filePath);
+    HANDLE hFile = CreateFileW(
+        widePath.c_str(),
+        GENERIC_READ,
+        FILE_SHARE_READ,
+        nullptr,
+        OPEN_EXISTING,
+        FILE_ATTRIBUTE_NORMAL | FILE_FLAG_RANDOM_ACCESS,
+        nullptr
+    );
+    if (hFile == INVALID_HANDLE_VALUE) {
+        return false;
+    }
+
+    LARGE_INTEGER fileSize;
+    if (!GetFileSizeEx(hFile, &fileSize) || fileSize.QuadPart == 0) {
+        CloseHandle(hFile);
+        return false;
+    }
+
+    HANDLE hMapping = CreateFileMapping(hFile, nullptr, PAGE_READONLY, 0, 0, nullptr);
+    if (!hMapping) {
+        CloseHandle(hFile);
+        return false;
+    }
+
+    void* view = MapViewOfFile(hMapping, FILE_MAP_READ, 0, 0, 0);
+    if (!view) {
+        CloseHandle(hMapping);
+        CloseHandle(hFile);
+        return false;
+    }
+
+    fileHandle = hFile;
+    mappingHandle = hMapping;
+    mappedData = static_cast<const char*>(view);
+    mappedSize = static_cast<size_t>(fileSize.QuadPart);
+    return true;
+}
+
+void MappedFile::close() {
+    if (mappedData) {
+        UnmapViewOfFile(mappedData);
+        mappedData = nullptr;
+    }
+    if (mappingHandle) {
+        CloseHandle(mappingHandle);
+        mappingHandle = nullptr;
+    }
+    if (fileHandle) {
+        CloseHandle(fileHandle);
+        fileHandle = nullptr;
+    }
+    mappedSize = 0;
+}
+#else
+bool MappedFile::open(const std::string& filePath) {
+    close();
+
+    int fd = ::open(filePath.c_str(), O_RDONLY);
+    if (fd < 0) {
+        return false;
+    }
+
+    struct stat st;
+    if (fstat(fd, &st) != 0 || st.st_size <= 0) {
+        ::close(fd);
+        return false;
+    }
+
+    void* view = mmap(nullptr, static_cast<size_t>(st.st_size), PROT_READ, MAP_PRIVATE, fd, 0);
+    if (view == MAP_FAILED) {
+        ::close(fd);
+        return false;
+    }
+    // 区块按偏移随机读取
+    madvise(view, static_cast<size_t>(st.st_size), MADV_RANDOM);
+
+    fileDescriptor = fd;
+    mappedData = static_cast<const char*>(view);
+    mappedSize = static_cast<size_t>(st.st_size);
+    return true;
+}
+
+void MappedFile::close() {
+    if (mappedData) {
+        munmap(const_cast<char*>(mappedData), mappedSize);
+        mappedData = nullptr;
+    }
+    if (fileDescriptor >= 0) {
+        ::close(fileDescriptor);
+        fileDescriptor = -1;
+    }
+    mappedSize = 0;
+}
+#endif
+
+// --------------------------------------------------------------------------------
+// RegionHeader
+// --------------------------------------------------------------------------------
+bool RegionHeader::Parse(const char* data, size_t size) {
+    entries.fill(Entry());
+    present.reset();
+
+    if (!data || size < 2 * SectorSize) {
+        return false;
+    }
+
+    const unsigned char* locations = reinterpret_cast<const unsigned char*>(data);
+    const unsigned char* timestamps = locations + SectorSize;
+    const size_t sectorsInFile = size / SectorSize;
+
+    for (int i = 0; i < ChunkCount; ++i) {
+        const unsigned char* loc = locations + i * 4;
+        const unsigned char* ts = timestamps + i * 4;
+
+        Entry& entry = entries[i];
+        entry.sectorOffset = (static_cast<uint32_t>(loc[0]) << 16) |
+            (static_cast<uint32_t>(loc[1]) << 8) |
+            static_cast<uint32_t>(loc[2]);
+        entry.sectorCount = loc[3];
+        entry.timestamp = (static_cast<uint32_t>(ts[0]) << 24) |
+            (static_cast<uint32_t>(ts[1]) << 16) |
+            (static_cast<uint32_t>(ts[2]) << 8) |
+            static_cast<uint32_t>(ts[3]);
+
+        // 偏移落在文件头内或超出文件末尾的条目视为不存在
+        if (entry.sectorOffset >= 2 && entry.sectorCount > 0 && entry.sectorOffset < sectorsInFile) {
+            present.set(i);
+        }
+    }
+    return true;
+}
+
+std::vector<int> RegionHeader::GetChunksInSectorOrder() const {
+    std::vector<int> order;
+    order.reserve(present.count());
+    for (int i = 0; i < ChunkCount; ++i) {
+        if (present.test(i)) {
+            order.push_back(i);
+        }
+    }
+    std::sort(order.begin(), order.end(), [this](int a, int b) {
+        return entries[a].sectorOffset < entries[b].sectorOffset;
+        });
+    return order;
+}
+
+// --------------------------------------------------------------------------------
+// RegionFile
+// --------------------------------------------------------------------------------
+std::string RegionFile::BuildRegionPath(const std::string& worldPath, int regionX, int regionZ) {
+    std::ostringstream filePathStream;
+    filePathStream << worldPath << "/region/r." << regionX << "." << regionZ << ".mca";
+    return filePathStream.str();
+}
+
+bool RegionFile::open(const std::string& worldPath) {
+    this->worldPath = worldPath;
+    std::string filePath = BuildRegionPath(worldPath, regionX, regionZ);
+    if (!file.open(filePath)) {
+        std::cerr << "错误: 打开文件失败！" << filePath << std::endl;
+        return false;
+    }
+    if (!header.Parse(file.data(), file.size())) {
+        std::cerr << "错误: 区域文件头不完整: " << filePath << std::endl;
+        file.close();
+        return false;
+    }
+    return true;
+}
+
+ByteSpan RegionFile::GetChunkPayload(int localX, int localZ, uint8_t& compressionType) const {
+    compressionType = 0;
+    if (!header.HasChunk(localX, localZ)) {
+        return {};
+    }
+
+    const char* fileData = file.data();
+    const size_t fileSize = file.size();
+    const size_t offset = static_cast<size_t>(header.GetEntry(localX, localZ).sectorOffset) * RegionHeader::SectorSize;
+    if (offset + 5 > fileSize) {
+        return {};
+    }
+
+    // 区块头：4 字节长度（包含压缩类型字节）+ 1 字节压缩类型
+    const unsigned char* chunkHeader = reinterpret_cast<const unsigned char*>(fileData + offset);
+    size_t length = (static_cast<size_t>(chunkHeader[0]) << 24) |
+        (static_cast<size_t>(chunkHeader[1]) << 16) |
+        (static_cast<size_t>(chunkHeader[2]) << 8) |
+        static_cast<size_t>(chunkHeader[3]);
+    if (length == 0 || offset + 4 + length > fileSize) {
+        return {};
+    }
+
+    compressionType = chunkHeader[4];
+    return { fileData + offset + 5, length - 1 };
+}
+
+bool RegionFile::OpenExternalChunk(int localX, int localZ, MappedFile& externalFile) const {
+    std::ostringstream filePathStream;
+    filePathStream << worldPath << "/region/c." << (regionX * 32 + (localX & 31))
+        << "." << (regionZ * 32 + (localZ & 31)) << ".mcc";
+    std::string filePath = filePathStream.str();
+    if (!externalFile.open(filePath)) {
+        std::cerr << "错误: 打开外部区块文件失败！" << filePath << std::endl;
+        return false;
+    }
+    return true;
+}
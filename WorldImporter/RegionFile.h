@@ -0,0 +1,114 @@
+// RegionFile.h
+#ifndef REGION_FILE_H
+#define REGION_FILE_H
+
+#include <string>
+#include <memory>
+#include <vector>
+#include <array>
+#include <bitset>
+#include <cstddef>
+#include <cstdint>
+
+// 只读字节视图，指向映射文件或缓冲区中的一段数据（不拥有内存）
+struct ByteSpan {
+    const char* data = nullptr;
+    size_t size = 0;
+
+    bool empty() const { return size == 0; }
+};
+
+// 只读内存映射文件（Windows 使用 CreateFileMapping，其他平台使用 POSIX mmap）
+class MappedFile {
+public:
+    MappedFile() = default;
+    ~MappedFile();
+
+    MappedFile(const MappedFile&) = delete;
+    MappedFile& operator=(const MappedFile&) = delete;
+
+    // 映射整个文件，失败时返回 false
+    bool open(const std::string& filePath);
+    void close();
+
+    bool isOpen() const { return mappedData != nullptr; }
+    const char* data() const { return mappedData; }
+    size_t size() const { return mappedSize; }
+
+private:
+    const char* mappedData = nullptr;
+    size_t mappedSize = 0;
+#ifdef _WIN32
+    void* fileHandle = nullptr;
+    void* mappingHandle = nullptr;
+#else
+    int fileDescriptor = -1;
+#endif
+};
+
+// 区域文件头索引：8 KiB 文件头（位置表 + 时间戳表）在打开区域时只解析一次
+struct RegionHeader {
+    static constexpr int ChunkCount = 1024;
+    static constexpr size_t SectorSize = 4096;
+
+    struct Entry {
+        uint32_t sectorOffset = 0;  // 起始扇区（以 4 KiB 为单位）
+        uint8_t sectorCount = 0;    // 占用扇区数
+        uint32_t timestamp = 0;     // 最后修改时间（秒）
+    };
+
+    std::array<Entry, ChunkCount> entries{};
+    std::bitset<ChunkCount> present;  // 区块存在位图
+
+    // 区块在位置表中的下标，localX/localZ 取值 [0, 31]
+    static int Index(int localX, int localZ) { return (localX & 31) + (localZ & 31) * 32; }
+
+    // 解析文件头，文件不足 8 KiB 时返回 false
+    bool Parse(const char* data, size_t size);
+
+    bool HasChunk(int localX, int localZ) const { return present.test(Index(localX, localZ)); }
+    const Entry& GetEntry(int localX, int localZ) const { return entries[Index(localX, localZ)]; }
+    size_t GetChunkCount() const { return present.count(); }
+
+    // 返回所有存在区块的下标，按扇区偏移升序排列，便于顺序读取
+    std::vector<int> GetChunksInSectorOrder() const;
+};
+
+// 一个 r.X.Z.mca 区域文件，整个文件只映射一次，区块负载以视图形式返回
+class RegionFile {
+public:
+    RegionFile(int regionX, int regionZ) : regionX(regionX), regionZ(regionZ) {}
+
+    // 映射 worldPath/region/r.X.Z.mca
+    bool open(const std::string& worldPath);
+
+    bool isOpen() const { return file.isOpen(); }
+    int GetRegionX() const { return regionX; }
+    int GetRegionZ() const { return regionZ; }
+    size_t GetFileSize() const { return file.size(); }
+    const RegionHeader& GetHeader() const { return header; }
+
+    // O(1) 判断区块是否存在，不读取区块数据
+    bool HasChunk(int localX, int localZ) const { return header.HasChunk(localX, localZ); }
+
+    // 获取区块的压缩负载（不含 5 字节区块头），localX/localZ 取值 [0, 31]
+    // 区块不存在或数据越界时返回空视图
+    ByteSpan GetChunkPayload(int localX, int localZ, uint8_t& compressionType) const;
+
+    // 映射超过 1 MiB 的外部区块文件 c.X.Z.mcc（压缩类型带 0x80 标志时使用）
+    bool OpenExternalChunk(int localX, int localZ, MappedFile& externalFile) const;
+
+    // 构造区域文件路径
+    static std::string BuildRegionPath(const std::string& worldPath, int regionX, int regionZ);
+
+private:
+    int regionX;
+    int regionZ;
+    std::string worldPath;
+    MappedFile file;
+    RegionHeader header;
+};
+
+using RegionFilePtr = std::shared_ptr<const RegionFile>;
+
+#endif // REGION_FILE_H
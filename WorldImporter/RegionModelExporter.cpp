@@ -1,12 +1,19 @@
-#include "RegionModelExporter.h"
+﻿#include "RegionModelExporter.h"
+#include "SectionCursor.h"
 #include "coord_conversion.h"
 #include "objExporter.h"
 #include "biome.h"
+#include "MeshCache.h"
+#include "ParallelFor.h"
+#include "GreedyMesher.h"
+#include "BakedModel.h"
 #include <iomanip>  // 用于 std::setw 和 std::setfill
 #include <sstream>  // 用于 std::ostringstream
 #include <regex>
 #include <chrono>  // 新增：用于时间测量
+#include <climits>
 #include <iostream>  // 新增：用于输出时间
+#include <thread>
 
 using namespace std;
 using namespace std::chrono;  // 新增：方便使用 chrono
@@ -95,8 +102,10 @@ void deduplicateFaces(ModelData& data, bool checkMaterial = true) {
         faceCount[key]++;
     }
 
-    // 第二次遍历：过滤数据
+    // 第二次遍历：过滤数据，faceDirections 与面一一对应时一并过滤
+    bool keepDirections = data.faceDirections.size() * 4 == data.faces.size();
     std::vector<int> newFaces, newUvFaces, newMaterials;
+    std::vector<FaceIndex> newDirections;
     for (size_t i = 0; i < data.faces.size(); i += 4) {
         std::array<int, 4> face = {
             data.faces[i], data.faces[i + 1],
@@ -114,58 +123,217 @@ void deduplicateFaces(ModelData& data, bool checkMaterial = true) {
                 data.uvFaces.begin() + i,
                 data.uvFaces.begin() + i + 4);
             newMaterials.push_back(data.materialIndices[i / 4]);
+            if (keepDirections) {
+                newDirections.push_back(data.faceDirections[i / 4]);
+            }
         }
     }
 
     data.faces.swap(newFaces);
     data.uvFaces.swap(newUvFaces);
     data.materialIndices.swap(newMaterials);
+    // 长度不匹配的方向数组无法对齐，直接清空
+    data.faceDirections.swap(newDirections);
 }
 
 
 void RegionModelExporter::ExportRegionModels(int xStart, int xEnd, int yStart, int yEnd,
     int zStart, int zEnd, const string& outputName) {
-    auto start = high_resolution_clock::now();  // 新增：开始时间点
-    // 收集区域内所有唯一方块ID
-    LoadChunks(xStart, xEnd, yStart, yEnd, zStart, zEnd);
-    auto end = high_resolution_clock::now();  // 新增：结束时间点
-    auto duration = duration_cast<milliseconds>(end - start);  // 新增：计算时间差
-    cout << "LoadChunks耗时: " << duration.count() << " ms" << endl;  // 新增：输出到控制台
-    UpdateSkyLightNeighborFlags();
-    auto blocks = GetGlobalBlockPalette();
-    // 使用 ProcessBlockstateForBlocks 处理所有方块状态模型
-    ProcessBlockstateForBlocks(blocks);
-    
     // 获取区域内的所有区块范围（按16x16x16划分）
     int chunkXStart, chunkXEnd, chunkZStart, chunkZEnd, sectionYStart, sectionYEnd;
     blockToChunk(xStart, zStart, chunkXStart, chunkZStart);
     blockToChunk(xEnd, zEnd, chunkXEnd, chunkZEnd);
     blockYToSectionY(yStart, sectionYStart);
     blockYToSectionY(yEnd, sectionYEnd);
-    start = high_resolution_clock::now();  // 新增：开始时间点
-    // 遍历每个区块
+
+    // 导出范围（含网格生成访问的 ±1 邻居）内的子区块按坐标直接索引
+    SetSectionCacheBounds(chunkXStart - 1, chunkXEnd + 1, chunkZStart - 1, chunkZEnd + 1,
+        sectionYStart - 1, sectionYEnd + 1);
+
+    // 增量导出：区块及其四邻的时间戳、资源集合都未变化时直接复用磁盘上的网格
+    std::unique_ptr<MeshCache> meshCache;
+    std::unordered_map<long long, MeshCacheKey> meshCacheKeys;
+    std::unordered_set<long long> cachedChunks;
+    if (config.incrementalExport) {
+        meshCache = std::make_unique<MeshCache>("mesh_cache");
+        uint64_t resourceHash = MeshCache::ComputeResourceHash(config);
+        for (int chunkX = chunkXStart; chunkX <= chunkXEnd; ++chunkX) {
+            for (int chunkZ = chunkZStart; chunkZ <= chunkZEnd; ++chunkZ) {
+                MeshCacheKey key;
+                key.chunkX = chunkX;
+                key.chunkZ = chunkZ;
+                key.timestamp = GetChunkTimestamp(chunkX, chunkZ);
+                key.neighborStamp = 0;
+                const int neighborOffsets[4][2] = { {-1, 0}, {1, 0}, {0, -1}, {0, 1} };
+                for (const auto& offset : neighborOffsets) {
+                    key.neighborStamp = key.neighborStamp * 1099511628211ULL ^
+                        GetChunkTimestamp(chunkX + offset[0], chunkZ + offset[1]);
+                }
+                key.resourceHash = resourceHash;
+                key.sectionYStart = sectionYStart;
+                key.sectionYEnd = sectionYEnd;
+
+                long long chunkKey = ChunkKey(chunkX, chunkZ);
+                if (meshCache->Contains(key)) {
+                    cachedChunks.insert(chunkKey);
+                }
+                meshCacheKeys[chunkKey] = key;
+            }
+        }
+        cout << "网格缓存命中: " << cachedChunks.size() << " / " << meshCacheKeys.size() << " 个区块" << endl;
+    }
+
+    auto start = high_resolution_clock::now();  // 新增：开始时间点
+    // 按 chunkX 列分批：每批先加载本批需要的区块及 ±1 邻居（边解码边合并，加载期间预算有效），
+    // 为新出现的方块状态准备模型，再由主线程预取子区块后冻结缓存，
+    // 各线程以工作窃取方式并行生成子区块网格，结果按 (chunkX, chunkZ, sectionY) 顺序拼接，
+    // 与线程数和完成顺序无关
     ModelData finalMergedModel;
-    for (int chunkX = chunkXStart; chunkX <= chunkXEnd; ++chunkX) {
-        for (int chunkZ = chunkZStart; chunkZ <= chunkZEnd; ++chunkZ) {
-            for (int sectionY = sectionYStart; sectionY <= sectionYEnd; ++sectionY) {
-                // 生成当前区块的子模型
-                ModelData chunkModel = GenerateChunkModel(chunkX, sectionY, chunkZ);
-                // 合并到总模型
-                if (finalMergedModel.vertices.empty()) {
-                    finalMergedModel = chunkModel;
+    const int chunkZCount = chunkZEnd - chunkZStart + 1;
+    const int sectionCount = sectionYEnd - sectionYStart + 1;
+    const size_t threadCount = std::max<unsigned>(1, std::thread::hardware_concurrency());
+    // 每批至少给每个线程约 8 个子区块，留出窃取余地
+    const int batchColumns = std::max(1, static_cast<int>((threadCount * 8 + chunkZCount * sectionCount - 1) /
+        (chunkZCount * sectionCount)));
+
+    struct SectionTask {
+        int chunkX, chunkZ, sectionY, lodLevel;
+    };
+    std::vector<SectionTask> tasks;
+    std::vector<ModelData> sectionModels;               // 批内所有子区块网格，按列依次排列
+    std::vector<const ModelData*> parts;
+    std::unordered_set<long long> batchChunks;
+    size_t preparedBlocks = 0;
+    long long loadMilliseconds = 0;
+    int regionXStart, regionZStart, regionXEnd, regionZEnd;
+    chunkToRegion(chunkXStart - 1, chunkZStart - 1, regionXStart, regionZStart);
+    chunkToRegion(chunkXEnd + 1, chunkZEnd + 1, regionXEnd, regionZEnd);
+    int nextRegionToEvict = regionXStart;
+    for (int batchXStart = chunkXStart; batchXStart <= chunkXEnd; batchXStart += batchColumns) {
+        const int batchXEnd = std::min(chunkXEnd, batchXStart + batchColumns - 1);
+        const size_t chunkCount = static_cast<size_t>(batchXEnd - batchXStart + 1) * chunkZCount;
+        sectionModels.assign(chunkCount * sectionCount, ModelData());
+        tasks.clear();
+
+        // 网格缓存命中的列直接读取，其余列需要生成网格，收集它们及 ±1 邻居区块
+        std::vector<bool> fromCache(chunkCount, false);
+        std::vector<ModelData> cachedModels;
+        batchChunks.clear();
+        size_t chunkIndex = 0;
+        for (int chunkX = batchXStart; chunkX <= batchXEnd; ++chunkX) {
+            for (int chunkZ = chunkZStart; chunkZ <= chunkZEnd; ++chunkZ, ++chunkIndex) {
+                long long chunkKey = ChunkKey(chunkX, chunkZ);
+                size_t first = chunkIndex * sectionCount;
+                cachedModels.clear();
+                if (cachedChunks.count(chunkKey) && meshCache->Load(meshCacheKeys[chunkKey], cachedModels)) {
+                    fromCache[chunkIndex] = true;
+                    // 缓存中的子区块数与当前范围一致（键包含 sectionY 范围）
+                    for (size_t k = 0; k < cachedModels.size() && k < static_cast<size_t>(sectionCount); ++k) {
+                        sectionModels[first + k] = std::move(cachedModels[k]);
+                    }
+                    continue;
+                }
+                for (int dx = -1; dx <= 1; ++dx) {
+                    for (int dz = -1; dz <= 1; ++dz) {
+                        batchChunks.insert(ChunkKey(chunkX + dx, chunkZ + dz));
+                    }
+                }
+            }
+        }
+
+        // 加载时仍按预算淘汰：之前批次遗留的子区块 LRU 时钟最旧，最先被换出
+        auto loadStart = high_resolution_clock::now();
+        LoadChunks(batchChunks, sectionYStart - 1, sectionYEnd + 1);
+        loadMilliseconds += duration_cast<milliseconds>(high_resolution_clock::now() - loadStart).count();
+
+        // 需要生成网格的列加入任务并预取 ±1 邻居；
+        // 预取到网格生成结束前暂停淘汰，否则超出预算时先预取的子区块会被换出，冻结后按不存在处理
+        SuspendCacheEviction(true);
+        chunkIndex = 0;
+        for (int chunkX = batchXStart; chunkX <= batchXEnd; ++chunkX) {
+            for (int chunkZ = chunkZStart; chunkZ <= chunkZEnd; ++chunkZ, ++chunkIndex) {
+                if (fromCache[chunkIndex]) {
+                    continue;
+                }
+                int lodLevel = ChunkLodLevel(chunkX, chunkZ);
+                for (int sectionY = sectionYStart; sectionY <= sectionYEnd; ++sectionY) {
+                    tasks.push_back({ chunkX, chunkZ, sectionY, lodLevel });
+                }
+                for (int dx = -1; dx <= 1; ++dx) {
+                    for (int dz = -1; dz <= 1; ++dz) {
+                        for (int sectionY = sectionYStart - 1; sectionY <= sectionYEnd + 1; ++sectionY) {
+                            AcquireSection(chunkX + dx, chunkZ + dz, AdjustSectionY(sectionY));
+                        }
+                    }
+                }
+            }
+        }
+
+        // 预取中按需加载的区块也可能带来新方块状态，全部加载完成后再准备模型
+        PrepareBlockModels(preparedBlocks);
+
+        FreezeSectionCache(true);
+        try {
+            ParallelFor(tasks.size(), [&](size_t t) {
+                const SectionTask& task = tasks[t];
+                size_t column = static_cast<size_t>(task.chunkX - batchXStart) * chunkZCount + (task.chunkZ - chunkZStart);
+                sectionModels[column * sectionCount + (task.sectionY - sectionYStart)] = task.lodLevel > 0 ?
+                    GenerateLodChunkModel(task.chunkX, task.sectionY, task.chunkZ, task.lodLevel) :
+                    GenerateChunkModel(task.chunkX, task.sectionY, task.chunkZ);
+                }, threadCount);
+        }
+        catch (...) {
+            FreezeSectionCache(false);
+            SuspendCacheEviction(false);
+            throw;
+        }
+        FreezeSectionCache(false);
+
+        // 按固定顺序写网格缓存并拼接
+        parts.clear();
+        chunkIndex = 0;
+        for (int chunkX = batchXStart; chunkX <= batchXEnd; ++chunkX) {
+            for (int chunkZ = chunkZStart; chunkZ <= chunkZEnd; ++chunkZ, ++chunkIndex) {
+                auto first = sectionModels.begin() + chunkIndex * sectionCount;
+                if (meshCache && !fromCache[chunkIndex]) {
+                    std::vector<ModelData> chunkModels(first, first + sectionCount);
+                    meshCache->Store(meshCacheKeys[ChunkKey(chunkX, chunkZ)], chunkModels);
                 }
-                else {
-                    MergeModelsDirectly(finalMergedModel, chunkModel);
+                for (auto it = first; it != first + sectionCount; ++it) {
+                    parts.push_back(&*it);
                 }
-                
-                
             }
-           
+        }
+        AppendModels(finalMergedModel, parts);
+
+        // 网格生成已越过本批之前的列（邻居只访问 ±1），释放其子区块，保留本批最后一列供下一批使用
+        for (int chunkX = batchXStart - 1; chunkX < batchXEnd; ++chunkX) {
+            for (int chunkZ = chunkZStart - 1; chunkZ <= chunkZEnd + 1; ++chunkZ) {
+                EvictChunk(chunkX, chunkZ);
+            }
+        }
+        // 先释放已越过的列，再按预算淘汰剩余部分
+        SuspendCacheEviction(false);
+
+        // 之后的批次只访问 batchXEnd 及以后的列，释放已完全越过的区域文件映射
+        int batchRegionX, batchRegionZ;
+        chunkToRegion(batchXEnd, chunkZStart, batchRegionX, batchRegionZ);
+        for (; nextRegionToEvict < batchRegionX; ++nextRegionToEvict) {
+            for (int regionZ = regionZStart; regionZ <= regionZEnd; ++regionZ) {
+                EvictRegion(nextRegionToEvict, regionZ);
+            }
         }
     }
-    end = high_resolution_clock::now();  // 新增：结束时间点
-    duration = duration_cast<milliseconds>(end - start);  // 新增：计算时间差
+    for (; nextRegionToEvict <= regionXEnd; ++nextRegionToEvict) {
+        for (int regionZ = regionZStart; regionZ <= regionZEnd; ++regionZ) {
+            EvictRegion(nextRegionToEvict, regionZ);
+        }
+    }
+    auto end = high_resolution_clock::now();  // 新增：结束时间点
+    auto duration = duration_cast<milliseconds>(end - start);  // 新增：计算时间差
+    cout << "LoadChunks耗时: " << loadMilliseconds << " ms" << endl;
     cout << "模型合并耗时: " << duration.count() << " ms" << endl;  // 新增：输出到控制台
+    PrintCacheStats();
     start = high_resolution_clock::now();  // 新增：开始时间点
     deduplicateVertices(finalMergedModel);
     end = high_resolution_clock::now();  // 新增：结束时间点
@@ -189,165 +357,349 @@ void RegionModelExporter::ExportRegionModels(int xStart, int xEnd, int yStart, i
 }
 
 
+// 均匀实心子区块被六个均匀实心子区块包围时，所有参与剔除的面都被遮挡，
+// 模型中没有 DO_NOT_CULL 面时整个子区块不产生任何面
+static bool IsUniformSectionHidden(int chunkX, int sectionY, int chunkZ, int blockId) {
+    if (!(GetBlockStateInfo(blockId).flags & BLOCK_STATE_SOLID)) {
+        return false;
+    }
+
+    const int offsets[6][3] = {
+        {0, 1, 0}, {0, -1, 0}, {-1, 0, 0}, {1, 0, 0}, {0, 0, -1}, {0, 0, 1}
+    };
+    for (const auto& offset : offsets) {
+        int neighborId;
+        if (!IsSectionUniform(chunkX + offset[0], chunkZ + offset[2], sectionY + offset[1], neighborId) ||
+            !(GetBlockStateInfo(neighborId).flags & BLOCK_STATE_SOLID)) {
+            return false;
+        }
+    }
+
+    const BlockStateInfo& info = GetBlockStateInfo(blockId);
+    if (info.model.kind != BlockModelHandle::Unresolved) {
+        return !(info.flags & BLOCK_STATE_UNCULLED);
+    }
+    ModelData blockModel = GetBlockStateModel(info, chunkX * 16, sectionY * 16, chunkZ * 16);
+    for (FaceIndex dir : blockModel.faceDirections) {
+        if (dir == FACE_NONE) {
+            return false;
+        }
+    }
+    return true;
+}
+
 ModelData RegionModelExporter::GenerateChunkModel(int chunkX, int sectionY, int chunkZ) {
     ModelData chunkModel;
+    // 均匀子区块快速路径：全空气或被完全包围的实心子区块无需逐方块遍历
+    int uniformId;
+    if (IsSectionUniform(chunkX, chunkZ, sectionY, uniformId)) {
+        if ((GetBlockStateInfo(uniformId).flags & BLOCK_STATE_AIR) ||
+            IsUniformSectionHidden(chunkX, sectionY, chunkZ, uniformId)) {
+            return chunkModel;
+        }
+    }
     // 计算区块内的方块范围
     int blockXStart = chunkX * 16;
     int blockZStart = chunkZ * 16;
     int blockYStart = sectionY * 16;
-    // 遍历区块内的每个方块
-    for (int x = blockXStart; x < blockXStart + 16; ++x) {
-        for (int z = blockZStart; z < blockZStart + 16; ++z) {
-            int currentY = GetHeightMapY(x, z, "WORLD_SURFACE")-64;
-            for (int y = blockYStart; y < blockYStart + 16; ++y) {
-                bool neighbors[6];
-                int id = GetBlockIdWithNeighbors(x, y, z, neighbors);
-                string blockName = GetBlockNameById(id);
-                if (blockName == "minecraft:air" || y > currentY) continue;
-                if (GetSkyLight(x,y,z) == -1)continue;
-
-                string ns = GetBlockNamespaceById(id);
-                string bN;
-                string b;
-
-                // 标准化方块名称（去掉命名空间，处理状态）
-                size_t colonPos = blockName.find(':');
-                if (colonPos != string::npos) {
-                    blockName = blockName.substr(colonPos + 1);
-                }
+    // 子区块连同一圈邻居展开到游标中，邻居通过常量偏移访问
+    thread_local SectionCursor cursor;
+    cursor.Load(chunkX, sectionY, chunkZ, SectionCursor::LoadSkyLight | SectionCursor::LoadOcclusion);
+    // 完整立方体的可见面先记入掩码，遍历结束后合并输出
+    thread_local GreedyFaceMask greedyFaces;
+    greedyFaces.Reset();
+    thread_local std::vector<const ModelData*> pickedModels;
+    thread_local BakedMaterialMap bakedMaterials;
+    bakedMaterials.Reset();
+    // 每列的地表高度只查一次
+    int surfaceY[256];
+    for (int z = 0; z < 16; ++z) {
+        for (int x = 0; x < 16; ++x) {
+            surfaceY[(z << 4) | x] = GetHeightMapY(blockXStart + x, blockZStart + z, "WORLD_SURFACE") - 64;
+        }
+    }
+    // 只遍历至少有一个面未被不透明方块遮挡的方块，被完全包围的地形内部按位整体跳过
+    const OcclusionMask& hidden = cursor.Hidden();
+    for (int w = 0; w < 64; ++w) {
+        for (uint64_t visit = ~hidden.words[w]; visit; visit &= visit - 1) {
+            int yzx = (w << 6) | CountTrailingZeros(visit);
+            int localX = yzx & 15;
+            int localZ = (yzx >> 4) & 15;
+            int localY = yzx >> 8;
+            int x = blockXStart + localX;
+            int y = blockYStart + localY;
+            int z = blockZStart + localZ;
+            int index = SectionCursor::Index(localX, localY, localZ);
+            int id = cursor.BlockId(index);
+            // 方块状态元数据在注册时已算好，这里只按ID取表
+            const BlockStateInfo& info = GetBlockStateInfo(id);
+            if ((info.flags & BLOCK_STATE_AIR) || y > surfaceY[(localZ << 4) | localX]) continue;
+            if (cursor.SkyLight(index) == -1)continue;
+
+            // 各方向紧邻方块是否透明（未被遮挡），由位集直接读出；不参与剔除的面总是可见
+            bool visible[7];
+            for (int i = 0; i < 6; ++i) {
+                visible[i] = !cursor.Covered(i).Test(yzx);
+            }
+            visible[FACE_NONE] = true;
 
-                ModelData blockModel;
-            
-                // 处理其他方块
-                blockModel = GetRandomModelFromCache(ns,blockName);
-                // 剔除被遮挡的面
-                std::vector<int> validFaceIndices;
-                const std::unordered_map<std::string, int> directionToNeighborIndex = {
-                    {"down", 1},  // 假设neighbors[1]对应下方
-                    {"up", 0},    // neighbors[0]对应上方
-                    {"north", 4}, // neighbors[4]对应北
-                    {"south", 5}, // neighbors[5]对应南
-                    {"west", 2},  // neighbors[2]对应西
-                    {"east", 3}   // neighbors[3]对应东
-                };
-
-                // 检查faceDirections是否已初始化
-                if (blockModel.faceDirections.empty()) {
+            if (config.greedyMeshing) {
+                if (const GreedyCube* cube = FindGreedyCube(PickSingleModel(info.model, x, y, z))) {
+                    for (int i = 0; i < 6; ++i) {
+                        if (visible[i]) {
+                            greedyFaces.Set(i, yzx, cube->faceKey[i]);
+                        }
+                    }
                     continue;
                 }
+            }
 
-                // 检查faces大小是否为4的倍数
-                if (blockModel.faces.size() % 4 != 0) {
-                    throw std::runtime_error("faces size is not a multiple of 4");
+            // 模型已烘焙为四边形，按坐标选出模型后直接追加可见面，不复制 ModelData
+            PickModels(info.model.kind != BlockModelHandle::Unresolved ? info.model :
+                ResolveBlockModel(GetNamespaceName(info.namespaceId), info.key), x, y, z, pickedModels);
+            for (const ModelData* model : pickedModels) {
+                if (const BakedModel* baked = FindBakedModel(model)) {
+                    AppendBakedModel(*baked, x, y, z, visible, bakedMaterials, chunkModel);
                 }
+            }
+        }
+    }
 
-                // 遍历所有面（每4个顶点索引构成一个面）
-                for (size_t faceIdx = 0; faceIdx < blockModel.faces.size() / 4; ++faceIdx) {
-                    // 检查faceIdx是否超出范围
-                    if (faceIdx * 4 >= blockModel.faceDirections.size()) {
-                        throw std::runtime_error("faceIdx out of range");
-                    }
+    if (greedyFaces.dirty) {
+        ModelData greedyModel;
+        EmitGreedyFaces(greedyFaces, blockXStart, blockYStart, blockZStart, greedyModel);
+        if (chunkModel.vertices.empty()) {
+            chunkModel = std::move(greedyModel);
+        }
+        else {
+            MergeModelsDirectly(chunkModel, greedyModel);
+        }
+    }
 
-                    std::string dir = blockModel.faceDirections[faceIdx * 4]; // 取第一个顶点的方向
-                    // 如果是 "DO_NOT_CULL"，保留该面
-                    if (dir == "DO_NOT_CULL") {
-                        validFaceIndices.push_back(faceIdx);
-                    }
-                    else {
-                        auto it = directionToNeighborIndex.find(dir);
-                        if (it != directionToNeighborIndex.end()) {
-                            int neighborIdx = it->second;
-                            if (!neighbors[neighborIdx]) { // 如果邻居存在（非空气），跳过该面
-                                continue;
-                            }
-                        }
-                        validFaceIndices.push_back(faceIdx);
-                    }
+    return chunkModel;
+}
 
-                }
+// 降采样用到的子区块数据：方块、光照，以及所在区块每列的地表高度
+struct LodSection {
+    const SectionCacheEntry* section;
+    int blockYStart;
+    int surfaceY[256];
+};
+
+static void LoadLodSection(LodSection& out, int chunkX, int sectionY, int chunkZ) {
+    out.section = &AcquireSection(chunkX, chunkZ, AdjustSectionY(sectionY));
+    out.blockYStart = sectionY * 16;
+    for (int z = 0; z < 16; ++z) {
+        for (int x = 0; x < 16; ++x) {
+            out.surfaceY[(z << 4) | x] = GetHeightMapY(chunkX * 16 + x, chunkZ * 16 + z, "WORLD_SURFACE") - 64;
+        }
+    }
+}
 
-                // 重建面数据（顶点、UV、材质）
-                ModelData filteredModel;
-                for (int faceIdx : validFaceIndices) {
-                    // 提取原面数据（4个顶点索引）
-                    for (int i = 0; i < 4; ++i) {
-                        filteredModel.faces.push_back(blockModel.faces[faceIdx * 4 + i]);
-                        filteredModel.uvFaces.push_back(blockModel.uvFaces[faceIdx * 4 + i]);
-                    }
-                    // 材质索引
-                    filteredModel.materialIndices.push_back(blockModel.materialIndices[faceIdx]);
-                    // 方向记录（每个顶点重复方向，这里仅记录一次）
-                    filteredModel.faceDirections.push_back(blockModel.faceDirections[faceIdx * 4]);
+// 统计一个 scale^3 单元内的方块：不透明方块占一半以上时返回其中最多的完整立方体方块的外观，否则返回 nullptr
+// 与完整精度网格相同，地表以上和没有天空光照（-1）的方块不计入
+// 同一状态统一使用一个变种，便于相邻单元合并
+static const GreedyCube* DownsampleCell(const LodSection& lod, int x0, int y0, int z0, int scale) {
+    struct Candidate {
+        int id;
+        int count;
+    };
+    Candidate candidates[64];
+    int candidateCount = 0;
+    int solidCount = 0;
+    for (int y = y0; y < y0 + scale; ++y) {
+        for (int z = z0; z < z0 + scale; ++z) {
+            for (int x = x0; x < x0 + scale; ++x) {
+                if (lod.blockYStart + y > lod.surfaceY[(z << 4) | x]) continue;
+                int yzx = toYZX(x, y, z);
+                int id = lod.section->blocks.Get(yzx);
+                if (!(GetBlockStateInfo(id).flags & BLOCK_STATE_SOLID)) continue;
+                if (GetSectionSkyLight(*lod.section, yzx) == -1) continue;
+                ++solidCount;
+                int c = 0;
+                while (c < candidateCount && candidates[c].id != id) ++c;
+                if (c == candidateCount) {
+                    candidates[candidateCount++] = { id, 0 };
                 }
+                ++candidates[c].count;
+            }
+        }
+    }
+    if (solidCount * 2 < scale * scale * scale) {
+        return nullptr;
+    }
 
-                // 顶点和UV数据保持不变（后续合并时会去重）
-                filteredModel.vertices = blockModel.vertices;
-                filteredModel.uvCoordinates = blockModel.uvCoordinates;
-                filteredModel.materialNames = blockModel.materialNames;
-                filteredModel.texturePaths = blockModel.texturePaths;
+    const GreedyCube* best = nullptr;
+    int bestCount = 0;
+    for (int c = 0; c < candidateCount; ++c) {
+        if (candidates[c].count <= bestCount) continue;
+        const GreedyCube* cube = FindGreedyCube(PickSingleModel(GetBlockStateInfo(candidates[c].id).model, 0, 0, 0));
+        if (cube) {
+            best = cube;
+            bestCount = candidates[c].count;
+        }
+    }
+    return best;
+}
 
-                // 使用过滤后的模型
-                blockModel = filteredModel;
-            
+ModelData RegionModelExporter::GenerateLodChunkModel(int chunkX, int sectionY, int chunkZ, int lodLevel) {
+    ModelData chunkModel;
+    int uniformId;
+    if (IsSectionUniform(chunkX, chunkZ, sectionY, uniformId)) {
+        if ((GetBlockStateInfo(uniformId).flags & BLOCK_STATE_AIR) ||
+            IsUniformSectionHidden(chunkX, sectionY, chunkZ, uniformId)) {
+            return chunkModel;
+        }
+    }
 
-                
-                ApplyPositionOffset(blockModel, x, y, z);
+    const int scale = 1 << std::min(lodLevel, 2);
+    const int cells = 16 / scale;
+    thread_local LodSection lod;
+    LoadLodSection(lod, chunkX, sectionY, chunkZ);
+    const GreedyCube* cellCubes[8 * 8 * 8];
+    for (int cy = 0; cy < cells; ++cy) {
+        for (int cz = 0; cz < cells; ++cz) {
+            for (int cx = 0; cx < cells; ++cx) {
+                cellCubes[(cy * cells + cz) * cells + cx] = DownsampleCell(lod, cx * scale, cy * scale, cz * scale, scale);
+            }
+        }
+    }
 
-                // 合并到主模型
-                if (chunkModel.vertices.empty()) {
-                    chunkModel = blockModel;
-                }
-                else {
-                    MergeModelsDirectly(chunkModel, blockModel);
-                }
+    // 相邻子区块只需要紧贴边界的一层单元
+    const int faceOffsets[6][3] = {
+        {0, 1, 0}, {0, -1, 0}, {-1, 0, 0}, {1, 0, 0}, {0, 0, -1}, {0, 0, 1}
+    };
+    bool borderFilled[6][8 * 8];
+    thread_local LodSection neighbor;
+    for (int d = 0; d < 6; ++d) {
+        LoadLodSection(neighbor, chunkX + faceOffsets[d][0], sectionY + faceOffsets[d][1], chunkZ + faceOffsets[d][2]);
+        for (int i = 0; i < cells; ++i) {
+            for (int j = 0; j < cells; ++j) {
+                // 邻居中与本子区块相接的那层单元，(i, j) 为面内两轴上的单元坐标
+                int cell[3];
+                int axis = faceOffsets[d][0] ? 0 : (faceOffsets[d][1] ? 1 : 2);
+                int positive = faceOffsets[d][axis] > 0;
+                cell[axis] = positive ? 0 : cells - 1;
+                cell[axis == 0 ? 1 : 0] = i;
+                cell[axis == 2 ? 1 : 2] = j;
+                borderFilled[d][i * cells + j] =
+                    DownsampleCell(neighbor, cell[0] * scale, cell[1] * scale, cell[2] * scale, scale) != nullptr;
             }
+        }
+    }
 
+    // 单元的外露面按方块精度写入掩码（单元外侧那一层方块的对应面），交给贪婪合并
+    thread_local GreedyFaceMask greedyFaces;
+    greedyFaces.Reset();
+    for (int cy = 0; cy < cells; ++cy) {
+        for (int cz = 0; cz < cells; ++cz) {
+            for (int cx = 0; cx < cells; ++cx) {
+                const GreedyCube* cube = cellCubes[(cy * cells + cz) * cells + cx];
+                if (!cube) continue;
+                const int cell[3] = { cx, cy, cz };
+                for (int d = 0; d < 6; ++d) {
+                    int axis = faceOffsets[d][0] ? 0 : (faceOffsets[d][1] ? 1 : 2);
+                    int next[3] = { cx + faceOffsets[d][0], cy + faceOffsets[d][1], cz + faceOffsets[d][2] };
+                    bool covered;
+                    if (next[axis] >= 0 && next[axis] < cells) {
+                        covered = cellCubes[(next[1] * cells + next[2]) * cells + next[0]] != nullptr;
+                    }
+                    else {
+                        int i = cell[axis == 0 ? 1 : 0];
+                        int j = cell[axis == 2 ? 1 : 2];
+                        covered = borderFilled[d][i * cells + j];
+                    }
+                    if (covered) continue;
+
+                    int block[3];
+                    block[axis] = cell[axis] * scale + (faceOffsets[d][axis] > 0 ? scale - 1 : 0);
+                    const int axisA = axis == 0 ? 1 : 0;
+                    const int axisB = axis == 2 ? 1 : 2;
+                    for (int a = 0; a < scale; ++a) {
+                        for (int b = 0; b < scale; ++b) {
+                            block[axisA] = cell[axisA] * scale + a;
+                            block[axisB] = cell[axisB] * scale + b;
+                            greedyFaces.Set(d, toYZX(block[0], block[1], block[2]), cube->faceKey[d]);
+                        }
+                    }
+                }
+            }
         }
     }
 
+    EmitGreedyFaces(greedyFaces, chunkX * 16, sectionY * 16, chunkZ * 16, chunkModel);
     return chunkModel;
 }
 
-void RegionModelExporter::LoadChunks(int xStart, int xEnd, int yStart, int yEnd, int zStart, int zEnd) {
-    // 计算最小和最大坐标，以处理范围颠倒的情况
-    int min_x = min(xStart, xEnd);
-    int max_x = max(xStart, xEnd);
-    int min_z = min(zStart, zEnd);
-    int max_z = max(zStart, zEnd);
-    int min_y = min(yStart, yEnd);
-    int max_y = max(yStart, yEnd);
-
-    // 计算分块的范围（每个分块宽度为 16 块）
-    int chunkXStart, chunkXEnd, chunkZStart, chunkZEnd;
-    blockToChunk(min_x, min_z, chunkXStart, chunkZStart);
-    blockToChunk(max_x, max_z, chunkXEnd, chunkZEnd);
-
-    // 处理可能的负数和范围计算
-    chunkXStart = floor((float)min_x / 16.0f);
-    chunkXEnd = ceil((float)max_x / 16.0f);
-    chunkZStart = floor((float)min_z / 16.0f);
-    chunkZEnd = ceil((float)max_z / 16.0f);
-
-    // 计算分段 Y 范围（每个分段高度为 16 块）
-    int sectionYStart, sectionYEnd;
-    blockYToSectionY(min_y, sectionYStart);
-    blockYToSectionY(max_y, sectionYEnd);
-    sectionYStart = static_cast<int>(floor((float)min_y / 16.0f));
-    sectionYEnd = static_cast<int>(ceil((float)max_y / 16.0f));
-
-    // 加载所有相关的分块和分段
-    for (int chunkX = chunkXStart; chunkX <= chunkXEnd; ++chunkX) {
-        for (int chunkZ = chunkZStart; chunkZ <= chunkZEnd; ++chunkZ) {
-            // 加载并缓存整个 chunk 的所有子区块
-            LoadAndCacheBlockData(chunkX, chunkZ);
+int RegionModelExporter::ChunkLodLevel(int chunkX, int chunkZ) {
+    if (config.lodLevel <= 0 || config.lodDistance <= 0) {
+        return std::max(config.lodLevel, 0);
+    }
+    double dx = chunkX * 16 + 8 - config.lodCenterX;
+    double dz = chunkZ * 16 + 8 - config.lodCenterZ;
+    int ring = static_cast<int>(std::sqrt(dx * dx + dz * dz) / config.lodDistance);
+    return std::min(ring, config.lodLevel);
+}
+
+void RegionModelExporter::LoadChunks(const std::unordered_set<long long>& chunkKeys, int sectionYMin, int sectionYMax) {
+    // 过滤掉已在缓存中的区块（上一批保留的最后一列及其邻居），并求出所涉及的区域范围
+    std::unordered_set<long long> pending;
+    int chunkXStart = INT_MAX, chunkXEnd = INT_MIN, chunkZStart = INT_MAX, chunkZEnd = INT_MIN;
+    for (long long key : chunkKeys) {
+        int chunkX = static_cast<int>(key >> 32);
+        int chunkZ = static_cast<int>(static_cast<uint32_t>(key));
+        if (IsChunkCached(chunkX, chunkZ, AdjustSectionY(sectionYMin), AdjustSectionY(sectionYMax))) {
+            continue;
         }
+        pending.insert(key);
+        chunkXStart = std::min(chunkXStart, chunkX);
+        chunkXEnd = std::max(chunkXEnd, chunkX);
+        chunkZStart = std::min(chunkZStart, chunkZ);
+        chunkZEnd = std::max(chunkZEnd, chunkZ);
     }
+    if (pending.empty()) {
+        return;
+    }
+
+    // 按区域分组收集：每个区域的文件头只解析一次，
+    // 未生成的区块通过存在位图直接跳过，其余按扇区偏移顺序排队
+    std::vector<std::pair<int, int>> chunks;
+    int regionXStart, regionZStart, regionXEnd, regionZEnd;
+    chunkToRegion(chunkXStart, chunkZStart, regionXStart, regionZStart);
+    chunkToRegion(chunkXEnd, chunkZEnd, regionXEnd, regionZEnd);
+
+    for (int regionX = regionXStart; regionX <= regionXEnd; ++regionX) {
+        for (int regionZ = regionZStart; regionZ <= regionZEnd; ++regionZ) {
+            RegionFilePtr region = getRegionFromCache(regionX, regionZ);
+            if (!region->isOpen()) {
+                continue;
+            }
+
+            for (int index : region->GetHeader().GetChunksInSectorOrder()) {
+                int chunkX = regionX * 32 + index % 32;
+                int chunkZ = regionZ * 32 + index / 32;
+                if (pending.count(ChunkKey(chunkX, chunkZ))) {
+                    chunks.emplace_back(chunkX, chunkZ);
+                }
+            }
+        }
+    }
+
+    // 多线程解码并缓存这批 chunk 的子区块
+    LoadChunksParallel(chunks, AdjustSectionY(sectionYMin), AdjustSectionY(sectionYMax));
 }
 
-void RegionModelExporter::ApplyPositionOffset(ModelData& model, int x, int y, int z) {
-    for (size_t i = 0; i < model.vertices.size(); i += 3) {
-        model.vertices[i] += x;    // X坐标偏移
-        model.vertices[i + 1] += y;  // Y坐标偏移
-        model.vertices[i + 2] += z;  // Z坐标偏移
+void RegionModelExporter::PrepareBlockModels(size_t& preparedBlocks) {
+    size_t paletteSize = GetGlobalBlockPaletteSize();
+    if (paletteSize == preparedBlocks) {
+        return;
+    }
+    // 只为新方块状态读取 blockstate；模型解析、烘焙和完整立方体表依赖整个模型缓存，重新建立
+    std::vector<Block> blocks = GetGlobalBlockPalette();
+    ProcessBlockstateForBlocks(std::vector<Block>(blocks.begin() + preparedBlocks, blocks.begin() + paletteSize));
+    BakeModelCaches();
+    if (config.greedyMeshing || config.lodLevel > 0) {
+        BuildGreedyCubeTable();
     }
-}
\ No newline at end of file
+    preparedBlocks = paletteSize;
+}
@@ -24,13 +24,22 @@ public:
         const std::string& outputName = "region_model");
 
     static ModelData GenerateChunkModel(int chunkX, int sectionY, int chunkZ);
+    // 降采样网格：lodLevel 为 1/2 时每 2x2x2 / 4x4x4 个方块合成一个单元，
+    // 单元取占多数的不透明完整方块，再剔除并合并面
+    static ModelData GenerateLodChunkModel(int chunkX, int sectionY, int chunkZ, int lodLevel);
 
 private:
-    // 获取区域内所有唯一的方块ID（带状态）
-    static void LoadChunks(int xStart, int xEnd, int yStart,
-        int yEnd, int zStart, int zEnd);
-    // 应用顶点偏移
-    static void ApplyPositionOffset(ModelData& model, int x, int y, int z);
+    // 加载一批区块（ChunkKey 编码）：[sectionYMin, sectionYMax] 内的子区块已全部在缓存中的跳过，
+    // 其余按区域分组、按扇区偏移顺序排队后多线程解码
+    static void LoadChunks(const std::unordered_set<long long>& chunkKeys, int sectionYMin, int sectionYMax);
+    // 为上次调用以来新加入全局调色板的方块状态读取模型，并重新解析、烘焙模型表
+    static void PrepareBlockModels(size_t& preparedBlocks);
+    // 区块使用的 LOD 等级（config.lodDistance > 0 时按到中心的距离逐级提高，不超过 config.lodLevel）
+    static int ChunkLodLevel(int chunkX, int chunkZ);
+    // 将区块坐标编码为 64 位键
+    static long long ChunkKey(int chunkX, int chunkZ) {
+        return (static_cast<long long>(chunkX) << 32) | static_cast<uint32_t>(chunkZ);
+    }
 };
 
 #endif // REGION_MODEL_EXPORTER_H
\ No newline at end of file
@@ -0,0 +1,103 @@
+﻿#include "SectionCursor.h"
+#include "block.h"
+#include "coord_conversion.h"
+#include <algorithm>
+
+void SectionCursor::Load(int chunkX, int sectionY, int chunkZ, uint8_t flags) {
+    const bool withSky = (flags & LoadSkyLight) != 0;
+    const bool withBlock = (flags & LoadBlockLight) != 0;
+    if (withSky) skyLight.assign(Volume, 0);
+    if (withBlock) blockLight.assign(Volume, 0);
+    const bool withOcclusion = (flags & LoadOcclusion) != 0;
+    OcclusionMask centerOpaque;
+    OcclusionMask neighborOpaque[6];
+    bool centerMayBeUnculled = false;
+
+    // 按 27 个子区块（中心及其邻居）分块填充，每个子区块只查一次缓存；
+    // 邻居只取紧贴中心的一层，中心整体解包
+    for (int dy = -1; dy <= 1; ++dy) {
+        for (int dz = -1; dz <= 1; ++dz) {
+            for (int dx = -1; dx <= 1; ++dx) {
+                // 该子区块覆盖的局部坐标范围（相对中心子区块）
+                const int xMin = dx < 0 ? -1 : (dx > 0 ? 16 : 0), xMax = dx < 0 ? -1 : (dx > 0 ? 16 : 15);
+                const int yMin = dy < 0 ? -1 : (dy > 0 ? 16 : 0), yMax = dy < 0 ? -1 : (dy > 0 ? 16 : 15);
+                const int zMin = dz < 0 ? -1 : (dz > 0 ? 16 : 0), zMax = dz < 0 ? -1 : (dz > 0 ? 16 : 15);
+
+                // AcquireSection 可能触发加载与淘汰，条目引用只在本次填充内使用
+                const SectionCacheEntry& section = AcquireSection(chunkX + dx, chunkZ + dz, AdjustSectionY(sectionY + dy));
+                const PalettedContainer& blocks = section.blocks;
+                const bool center = (dx == 0 && dy == 0 && dz == 0);
+                if (center) {
+                    uniform = blocks.IsUniform();
+                }
+
+                if (withOcclusion) {
+                    int offsetCount = (dx != 0) + (dy != 0) + (dz != 0);
+                    if (center) {
+                        centerOpaque = section.opaque;
+                        // 调色板中有含 DO_NOT_CULL 面（或模型未解析）的不透明方块时，被包围的方块需逐个确认
+                        for (int id : blocks.Palette()) {
+                            const BlockStateInfo& info = GetBlockStateInfo(id);
+                            if ((info.flags & BLOCK_STATE_SOLID) &&
+                                ((info.flags & BLOCK_STATE_UNCULLED) || info.model.kind == BlockModelHandle::Unresolved)) {
+                                centerMayBeUnculled = true;
+                            }
+                        }
+                    }
+                    else if (offsetCount == 1) {
+                        int face = dy > 0 ? FACE_UP : dy < 0 ? FACE_DOWN : dx < 0 ? FACE_WEST :
+                            dx > 0 ? FACE_EAST : dz < 0 ? FACE_NORTH : FACE_SOUTH;
+                        neighborOpaque[face] = section.opaque;
+                    }
+                }
+
+                if (center && !blocks.IsUniform()) {
+                    int unpacked[SectionVolume];
+                    blocks.Unpack(unpacked);
+                    for (int y = 0; y < 16; ++y) {
+                        for (int z = 0; z < 16; ++z) {
+                            std::copy(unpacked + toYZX(0, y, z), unpacked + toYZX(0, y, z) + 16,
+                                blockIds.begin() + Index(0, y, z));
+                        }
+                    }
+                }
+                if (center && !blocks.IsUniform() && !withSky && !withBlock) {
+                    continue;
+                }
+
+                for (int y = yMin; y <= yMax; ++y) {
+                    for (int z = zMin; z <= zMax; ++z) {
+                        for (int x = xMin; x <= xMax; ++x) {
+                            const int index = Index(x, y, z);
+                            const int yzx = toYZX(x & 15, y & 15, z & 15);
+                            if (!center) {
+                                blockIds[index] = blocks.Get(yzx);
+                            }
+                            else if (blocks.IsUniform()) {
+                                blockIds[index] = blocks.UniformId();
+                            }
+                            if (withSky) skyLight[index] = static_cast<int8_t>(GetSectionSkyLight(section, yzx));
+                            if (withBlock) blockLight[index] = static_cast<int8_t>(GetSectionBlockLight(section, yzx));
+                        }
+                    }
+                }
+            }
+        }
+    }
+
+    if (withOcclusion) {
+        ComputeCoveredFaces(centerOpaque, neighborOpaque, covered);
+        ComputeHiddenBlocks(centerOpaque, covered, hidden);
+        if (centerMayBeUnculled) {
+            for (int w = 0; w < 64; ++w) {
+                for (uint64_t bits = hidden.words[w]; bits; bits &= bits - 1) {
+                    int yzx = (w << 6) | CountTrailingZeros(bits);
+                    const BlockStateInfo& info = GetBlockStateInfo(BlockId(Index(yzx & 15, yzx >> 8, (yzx >> 4) & 15)));
+                    if ((info.flags & BLOCK_STATE_UNCULLED) || info.model.kind == BlockModelHandle::Unresolved) {
+                        hidden.words[w] &= ~(static_cast<uint64_t>(1) << (yzx & 63));
+                    }
+                }
+            }
+        }
+    }
+}
@@ -0,0 +1,66 @@
+// SectionCursor.h
+#ifndef SECTION_CURSOR_H
+#define SECTION_CURSOR_H
+
+#include "OcclusionMask.h"
+#include <vector>
+#include <cstdint>
+
+// 子区块游标：把一个子区块的方块ID（可选光照）连同相邻子区块的一圈方块
+// 展开到 18x18x18 的缓冲中，邻居访问变为下标加常量偏移，不再逐方块查缓存
+class SectionCursor {
+public:
+    static constexpr int Size = 18;
+    static constexpr int Volume = Size * Size * Size;
+
+    // 相邻方块的下标偏移
+    static constexpr int OffsetUp = Size * Size;
+    static constexpr int OffsetDown = -Size * Size;
+    static constexpr int OffsetWest = -1;
+    static constexpr int OffsetEast = 1;
+    static constexpr int OffsetNorth = -Size;
+    static constexpr int OffsetSouth = Size;
+    // 顺序与 GetBlockIdWithNeighbors 的 neighborIsAir 一致：上、下、西、东、北、南
+    static constexpr int NeighborOffsets[6] = {
+        OffsetUp, OffsetDown, OffsetWest, OffsetEast, OffsetNorth, OffsetSouth
+    };
+
+    enum LoadFlags : uint8_t {
+        LoadBlocks = 0,
+        LoadSkyLight = 1 << 0,
+        LoadBlockLight = 1 << 1,
+        LoadOcclusion = 1 << 2      // 由各子区块的不透明位集计算遮挡
+    };
+
+    // 展开 (chunkX, sectionY, chunkZ) 子区块及一圈邻居（未加载的子区块按需加载）
+    void Load(int chunkX, int sectionY, int chunkZ, uint8_t flags = LoadBlocks);
+
+    // 子区块内局部坐标（-1..16）对应的缓冲下标
+    static int Index(int x, int y, int z) {
+        return ((y + 1) * Size + (z + 1)) * Size + (x + 1);
+    }
+
+    int BlockId(int index) const { return blockIds[index]; }
+    // 需以 LoadSkyLight / LoadBlockLight 加载，取值与 GetSkyLight / GetBlockLight 相同
+    int SkyLight(int index) const { return skyLight[index]; }
+    int BlockLight(int index) const { return blockLight[index]; }
+
+    // 中心子区块只含一种方块（邻居可以不同）
+    bool IsUniform() const { return uniform; }
+
+    // 需以 LoadOcclusion 加载，位下标为中心子区块的 yzx
+    // 方向 face（FaceIndex）上紧邻的方块不透明
+    const OcclusionMask& Covered(int face) const { return covered[face]; }
+    // 六个方向都被遮挡、且模型没有 DO_NOT_CULL 面的不透明方块，网格生成可以直接跳过
+    const OcclusionMask& Hidden() const { return hidden; }
+
+private:
+    std::vector<int> blockIds = std::vector<int>(Volume, 0);
+    std::vector<int8_t> skyLight;
+    std::vector<int8_t> blockLight;
+    bool uniform = false;
+    OcclusionMask covered[6];
+    OcclusionMask hidden;
+};
+
+#endif // SECTION_CURSOR_H
@@ -0,0 +1,233 @@
+﻿#include "benchmark.h"
+#include "config.h"
+#include "RegionFile.h"
+#include "decompressor.h"
+#include "byteswap.h"
+#include "bitunpack.h"
+#include "nbtutils.h"
+#include "coord_conversion.h"
+#include <iostream>
+#include <iomanip>
+#include <vector>
+#include <memory>
+#include <chrono>
+#include <algorithm>
+#include <cstring>
+#include <cmath>
+#include <random>
+
+using namespace std;
+using namespace std::chrono;
+
+extern Config config;
+
+namespace {
+    // 基准测试使用的一个区块负载（指向映射文件）
+    struct ChunkSample {
+        const char* data;
+        size_t size;
+        uint8_t compressionType;
+    };
+
+    // 收集导出范围内所有区域文件中的区块负载，regions 保持映射有效
+    vector<ChunkSample> CollectChunkSamples(const string& worldPath, int minX, int maxX, int minZ, int maxZ,
+        vector<unique_ptr<RegionFile>>& regions) {
+        int chunkXStart, chunkZStart, chunkXEnd, chunkZEnd;
+        blockToChunk(min(minX, maxX), min(minZ, maxZ), chunkXStart, chunkZStart);
+        blockToChunk(max(minX, maxX), max(minZ, maxZ), chunkXEnd, chunkZEnd);
+        int regionXStart, regionZStart, regionXEnd, regionZEnd;
+        chunkToRegion(chunkXStart, chunkZStart, regionXStart, regionZStart);
+        chunkToRegion(chunkXEnd, chunkZEnd, regionXEnd, regionZEnd);
+
+        vector<ChunkSample> samples;
+        for (int regionX = regionXStart; regionX <= regionXEnd; ++regionX) {
+            for (int regionZ = regionZStart; regionZ <= regionZEnd; ++regionZ) {
+                auto region = make_unique<RegionFile>(regionX, regionZ);
+                if (!region->open(worldPath)) {
+                    continue;
+                }
+                for (int index : region->GetHeader().GetChunksInSectorOrder()) {
+                    uint8_t compressionType = 0;
+                    ByteSpan payload = region->GetChunkPayload(index % 32, index / 32, compressionType);
+                    if (!payload.empty()) {
+                        samples.push_back({ payload.data, payload.size, compressionType });
+                    }
+                }
+                regions.push_back(std::move(region));
+            }
+        }
+        return samples;
+    }
+}
+
+void BenchmarkDecompression(const string& worldPath, int minX, int maxX, int minZ, int maxZ, int iterations) {
+    vector<unique_ptr<RegionFile>> regions;
+    vector<ChunkSample> samples = CollectChunkSamples(worldPath, minX, maxX, minZ, maxZ, regions);
+
+    // 旧路径只支持 zlib，对比时只取 zlib 区块
+    vector<ChunkSample> zlibSamples;
+    size_t compressedBytes = 0;
+    for (const auto& sample : samples) {
+        if (sample.compressionType == COMPRESSION_ZLIB) {
+            zlibSamples.push_back(sample);
+            compressedBytes += sample.size;
+        }
+    }
+    cout << "解压基准: 区域文件 " << regions.size() << " 个, 区块 " << samples.size()
+        << " 个, 其中 zlib 区块 " << zlibSamples.size() << " 个" << endl;
+    if (zlibSamples.empty()) {
+        return;
+    }
+
+    // 校验两条路径输出一致
+    vector<char> oldOutput;
+    vector<char> newOutput;
+    size_t mismatches = 0;
+    size_t decompressedBytes = 0;
+    for (const auto& sample : zlibSamples) {
+        bool oldOk = DecompressData(sample.data, sample.size, oldOutput);
+        bool newOk = DecompressChunk(sample.data, sample.size, sample.compressionType, newOutput);
+        if (oldOk != newOk || oldOutput != newOutput) {
+            ++mismatches;
+        }
+        decompressedBytes += newOutput.size();
+    }
+    if (mismatches > 0) {
+        cerr << "错误: " << mismatches << " 个区块的解压结果不一致" << endl;
+    }
+
+    auto report = [&](const char* name, long long us) {
+        double seconds = us / 1e6;
+        double mb = static_cast<double>(decompressedBytes) * iterations / (1024.0 * 1024.0);
+        cout << "  " << name << ": " << us / 1000 << " ms, "
+            << (seconds > 0 ? mb / seconds : 0.0) << " MB/s (解压后)" << endl;
+        };
+
+    // 旧路径：每个区块使用新的输出缓冲
+    auto start = high_resolution_clock::now();
+    for (int i = 0; i < iterations; ++i) {
+        for (const auto& sample : zlibSamples) {
+            vector<char> output;
+            DecompressData(sample.data, sample.size, output);
+        }
+    }
+    auto end = high_resolution_clock::now();
+    report("DecompressData", duration_cast<microseconds>(end - start).count());
+
+    // 新路径：线程私有 z_stream + 复用输出缓冲
+    vector<char> output;
+    start = high_resolution_clock::now();
+    for (int i = 0; i < iterations; ++i) {
+        for (const auto& sample : zlibSamples) {
+            DecompressChunk(sample.data, sample.size, sample.compressionType, output);
+        }
+    }
+    end = high_resolution_clock::now();
+    report("DecompressChunk", duration_cast<microseconds>(end - start).count());
+
+    cout << "  压缩数据 " << compressedBytes << " 字节, 解压后 " << decompressedBytes << " 字节" << endl;
+}
+
+void BenchmarkByteSwap(size_t longCount, int iterations) {
+    // 构造大端测试数据
+    vector<char> source(longCount * sizeof(int64_t));
+    for (size_t i = 0; i < source.size(); ++i) {
+        source[i] = static_cast<char>(i * 131 + 7);
+    }
+
+    vector<long long> scalarOutput(longCount);
+    HostLongBuffer simdOutput(longCount);
+
+    auto report = [&](const char* name, long long us) {
+        double seconds = us / 1e6;
+        double mb = static_cast<double>(source.size()) * iterations / (1024.0 * 1024.0);
+        cout << "  " << name << ": " << us / 1000 << " ms, "
+            << (seconds > 0 ? mb / seconds : 0.0) << " MB/s" << endl;
+        };
+
+    cout << "字节序转换基准: " << longCount << " 个 long, 实现 " << GetByteSwapBackend() << endl;
+
+    auto start = high_resolution_clock::now();
+    for (int i = 0; i < iterations; ++i) {
+        for (size_t j = 0; j < longCount; ++j) {
+            long long value;
+            memcpy(&value, source.data() + j * sizeof(long long), sizeof(long long));
+            scalarOutput[j] = reverseEndian(value);
+        }
+    }
+    auto end = high_resolution_clock::now();
+    report("reverseEndian", duration_cast<microseconds>(end - start).count());
+
+    start = high_resolution_clock::now();
+    for (int i = 0; i < iterations; ++i) {
+        ByteSwapArray64(source.data(), simdOutput.data(), longCount);
+    }
+    end = high_resolution_clock::now();
+    report("ByteSwapArray64", duration_cast<microseconds>(end - start).count());
+
+    for (size_t j = 0; j < longCount; ++j) {
+        if (static_cast<uint64_t>(scalarOutput[j]) != simdOutput[j]) {
+            cerr << "错误: 字节序转换结果不一致（下标 " << j << "）" << endl;
+            break;
+        }
+    }
+}
+
+void BenchmarkPaletteUnpack(int iterations) {
+    mt19937_64 random(12345);
+    cout << "调色板下标解包基准: 每个位宽 " << iterations << " 个子区块 (ns/子区块)" << endl;
+
+    for (int bits = 4; bits <= 15; ++bits) {
+        int perLong = 64 / bits;
+        size_t wordCount = (SectionVolume + perLong - 1) / perLong;
+        HostLongBuffer words(wordCount);
+        for (auto& word : words) {
+            word = random();
+        }
+
+        // 旧路径：log2 计算位宽，逐条目 push_back 到 vector<int>
+        vector<int> oldOutput;
+        auto start = high_resolution_clock::now();
+        for (int i = 0; i < iterations; ++i) {
+            oldOutput.clear();
+            size_t paletteSize = static_cast<size_t>(1) << bits;
+            int bitsPerState = (paletteSize <= 16) ? 4 : static_cast<int>(ceil(log2(paletteSize)));
+            int statesPerLong = 64 / bitsPerState;
+            int64_t mask = (1LL << bitsPerState) - 1;
+            for (size_t w = 0; w < wordCount; ++w) {
+                int64_t encodedState = static_cast<int64_t>(words[w]);
+                for (int j = 0; j < statesPerLong; ++j) {
+                    oldOutput.push_back(static_cast<int>((encodedState >> (j * bitsPerState)) & mask));
+                }
+            }
+        }
+        auto end = high_resolution_clock::now();
+        double oldNs = duration_cast<nanoseconds>(end - start).count() / static_cast<double>(iterations);
+
+        uint16_t indices[SectionVolume];
+        start = high_resolution_clock::now();
+        for (int i = 0; i < iterations; ++i) {
+            UnpackPaletteIndices(words.data(), wordCount, bits, indices);
+        }
+        end = high_resolution_clock::now();
+        double newNs = duration_cast<nanoseconds>(end - start).count() / static_cast<double>(iterations);
+
+        bool match = true;
+        for (int i = 0; i < SectionVolume; ++i) {
+            if (oldOutput[i] != indices[i]) {
+                match = false;
+                break;
+            }
+        }
+
+        cout << "  " << setw(2) << bits << " 位: 旧 " << static_cast<long long>(oldNs)
+            << ", 新 " << static_cast<long long>(newNs)
+            << (match ? "" : "  (错误: 结果不一致)") << endl;
+    }
+}
+
+void RunBenchmarks() {
+    BenchmarkDecompression(config.worldPath, config.minX, config.maxX, config.minZ, config.maxZ, 5);
+    BenchmarkByteSwap(1 << 20, 20);
+    BenchmarkPaletteUnpack(2000);
+}
@@ -0,0 +1,21 @@
+#ifndef BENCHMARK_H
+#define BENCHMARK_H
+
+#include <string>
+
+// 性能基准测试：在 config 中设置 status = 3 时由 main 调用
+// 所有测试都读取导出范围内的真实区域文件，结果输出到控制台
+
+// 对比旧的 DecompressData（uncompress + 10 倍估算重试）与流式 DecompressChunk
+void BenchmarkDecompression(const std::string& worldPath, int minX, int maxX, int minZ, int maxZ, int iterations);
+
+// 对比逐个 reverseEndian 与批量 ByteSwapArray64 转换 LONG_ARRAY 的速度
+void BenchmarkByteSwap(size_t longCount, int iterations);
+
+// 按位宽（4..15）对比逐条目 push_back 解包与特化内核 UnpackPaletteIndices 的速度
+void BenchmarkPaletteUnpack(int iterations);
+
+// 运行全部基准测试
+void RunBenchmarks();
+
+#endif // BENCHMARK_H
@@ -0,0 +1,21 @@
+﻿#include <iostream>
+#include "config.h"
+#include "benchmark.h"
+#include "global.h"
+
+Config config;  // 定义全局变量
+
+// 与 main.cpp 相同的版本缓存全局变量，基准测试不会填充它们
+std::unordered_map<std::string, std::vector<FolderData>> VersionCache;
+std::unordered_map<std::string, std::vector<FolderData>> modListCache;
+std::unordered_map<std::string, std::vector<FolderData>> resourcePacksCache;
+std::unordered_map<std::string, std::vector<FolderData>> saveFilesCache;
+std::string currentSelectedGameVersion;
+
+// 独立的基准测试入口：读取 config/config.json 中的世界路径与导出范围后运行全部基准测试
+int main(int argc, char* argv[]) {
+    std::string configFile = argc > 1 ? argv[1] : "config/config.json";
+    config = LoadConfig(configFile);
+    RunBenchmarks();
+    return 0;
+}
@@ -10,6 +10,7 @@
 #include <stdexcept>
 #include <fstream>
 #include <string>
+#include <filesystem>
 
 namespace {
     std::pair<std::string, std::string> splitBiomeName(const std::string& fullName) {
@@ -53,9 +54,14 @@ bool SaveColormapToFile(const std::vector<unsigned char>& pixelData,
     if (!pixelData.empty()) {
 
         // 获取当前工作目录（即 exe 所在的目录）
+#ifdef _WIN32
         char buffer[MAX_PATH];
         GetModuleFileNameA(NULL, buffer, MAX_PATH);
         std::string exePath = std::string(buffer);
+#else
+        std::error_code error;
+        std::string exePath = std::filesystem::read_symlink("/proc/self/exe", error).string();
+#endif
 
         // 获取 exe 所在目录
         size_t pos = exePath.find_last_of("\\/");
@@ -70,12 +76,11 @@ bool SaveColormapToFile(const std::vector<unsigned char>& pixelData,
         }
 
         // 创建保存目录（如果不存在）
-        if (GetFileAttributesA(savePath.c_str()) == INVALID_FILE_ATTRIBUTES) {
-            // 文件夹不存在，创建它
-            if (!CreateDirectoryA(savePath.c_str(), NULL)) {
-                std::cerr << "Failed to create directory: " << savePath << std::endl;
-                return false;
-            }
+        std::error_code createError;
+        std::filesystem::create_directories(savePath, createError);
+        if (createError) {
+            std::cerr << "Failed to create directory: " << savePath << std::endl;
+            return false;
         }
 
         // 处理 blockId，去掉路径部分，保留最后的文件名
@@ -102,6 +107,7 @@ bool SaveColormapToFile(const std::vector<unsigned char>& pixelData,
         std::cerr << "Failed to retrieve texture for " << colormapName << std::endl;
         return false;
     }
+    return true;
 }
 
 
@@ -115,15 +121,8 @@ int GetBiomeId(int blockX, int blockY, int blockZ) {
     blockYToSectionY(blockY, sectionY);
     int adjustedSectionY = AdjustSectionY(sectionY);
 
-    // 创建缓存键
-    auto blockKey = std::make_tuple(chunkX, chunkZ, adjustedSectionY);
-
-    // 检查 SectionCache 中是否存在对应的区块数据
-    if (sectionCache.find(blockKey) == sectionCache.end()) {
-        LoadAndCacheBlockData(chunkX, chunkZ);
-    }
-
-    const auto& biomeData = sectionCache[blockKey].biomeData;
+    // 从 SectionCache 获取对应的区块数据（未命中时自动加载）
+    const auto& biomeData = AcquireSection(chunkX, chunkZ, adjustedSectionY).biomeData;
 
     int biomeX = mod16(blockX) / 4;
     int biomeY = mod16(blockY) / 4;
@@ -0,0 +1,181 @@
+﻿#include "bitunpack.h"
+#include <algorithm>
+#include <cstring>
+
+#if defined(_M_X64) || defined(__x86_64__) || defined(_M_IX86) || defined(__i386__)
+#define WI_UNPACK_SSE2 1
+#include <emmintrin.h>
+#elif defined(__ARM_NEON) || defined(_M_ARM64)
+#define WI_UNPACK_NEON 1
+#include <arm_neon.h>
+#endif
+
+// 大于等于 n 的最小 2 的幂的指数
+static int CeilLog2(size_t n) {
+    int bits = 0;
+    while ((static_cast<size_t>(1) << bits) < n) {
+        ++bits;
+    }
+    return bits;
+}
+
+int BlockStateBits(size_t paletteSize) {
+    return std::max(4, CeilLog2(paletteSize));
+}
+
+int BiomeBits(size_t paletteSize) {
+    return std::max(1, CeilLog2(paletteSize));
+}
+
+// --------------------------------------------------------------------------------
+// 标量实现
+// --------------------------------------------------------------------------------
+void UnpackPaletteIndicesGeneric(const uint64_t* words, size_t wordCount, int bits, uint16_t* out, size_t count) {
+    const int perLong = 64 / bits;
+    const uint64_t mask = (static_cast<uint64_t>(1) << bits) - 1;
+    size_t written = 0;
+    for (size_t i = 0; i < wordCount && written < count; ++i) {
+        uint64_t word = words[i];
+        for (int j = 0; j < perLong && written < count; ++j) {
+            out[written++] = static_cast<uint16_t>(word & mask);
+            word >>= bits;
+        }
+    }
+    std::fill(out + written, out + count, static_cast<uint16_t>(0));
+}
+
+// 按位宽特化：内层循环次数为编译期常量，可完全展开，不再逐条目判断边界
+template <int Bits>
+static void UnpackFixed(const uint64_t* words, size_t wordCount, uint16_t* out, size_t count) {
+    static_assert(Bits >= 1 && Bits <= 16, "unsupported bit width");
+    constexpr int PerLong = 64 / Bits;
+    constexpr uint64_t Mask = (static_cast<uint64_t>(1) << Bits) - 1;
+
+    // 能整块写满 PerLong 个条目的 long 数
+    size_t fullWords = std::min(wordCount, count / PerLong);
+    for (size_t i = 0; i < fullWords; ++i) {
+        uint64_t word = words[i];
+        uint16_t* dst = out + i * PerLong;
+        for (int j = 0; j < PerLong; ++j) {
+            dst[j] = static_cast<uint16_t>((word >> (j * Bits)) & Mask);
+        }
+    }
+
+    // 尾部：最后一个不完整的 long，以及 words 不足时补 0
+    size_t written = fullWords * PerLong;
+    if (fullWords < wordCount && written < count) {
+        uint64_t word = words[fullWords];
+        for (; written < count && written < (fullWords + 1) * PerLong; ++written) {
+            out[written] = static_cast<uint16_t>(word & Mask);
+            word >>= Bits;
+        }
+    }
+    std::fill(out + written, out + count, static_cast<uint16_t>(0));
+}
+
+// --------------------------------------------------------------------------------
+// SIMD 实现（4 位与 8 位条目按字节对齐，小端 long 的字节顺序即条目顺序）
+// --------------------------------------------------------------------------------
+#ifdef WI_UNPACK_SSE2
+// 每次处理 16 字节 = 32 个 4 位下标
+static void UnpackSimd4(const uint64_t* words, size_t wordCount, uint16_t* out, size_t count) {
+    size_t blocks = std::min(wordCount / 2, count / 32);
+    const __m128i lowMask = _mm_set1_epi8(0x0F);
+    const __m128i zero = _mm_setzero_si128();
+    const char* src = reinterpret_cast<const char*>(words);
+    for (size_t i = 0; i < blocks; ++i) {
+        __m128i x = _mm_loadu_si128(reinterpret_cast<const __m128i*>(src + i * 16));
+        __m128i lo = _mm_and_si128(x, lowMask);
+        __m128i hi = _mm_and_si128(_mm_srli_epi16(x, 4), lowMask);
+        // 每个字节先低半字节后高半字节
+        __m128i first = _mm_unpacklo_epi8(lo, hi);
+        __m128i second = _mm_unpackhi_epi8(lo, hi);
+        __m128i* dst = reinterpret_cast<__m128i*>(out + i * 32);
+        _mm_storeu_si128(dst + 0, _mm_unpacklo_epi8(first, zero));
+        _mm_storeu_si128(dst + 1, _mm_unpackhi_epi8(first, zero));
+        _mm_storeu_si128(dst + 2, _mm_unpacklo_epi8(second, zero));
+        _mm_storeu_si128(dst + 3, _mm_unpackhi_epi8(second, zero));
+    }
+    size_t done = blocks * 2;
+    UnpackFixed<4>(words + done, wordCount - done, out + done * 16, count - done * 16);
+}
+
+// 每次处理 16 字节 = 16 个 8 位下标
+static void UnpackSimd8(const uint64_t* words, size_t wordCount, uint16_t* out, size_t count) {
+    size_t blocks = std::min(wordCount / 2, count / 16);
+    const __m128i zero = _mm_setzero_si128();
+    const char* src = reinterpret_cast<const char*>(words);
+    for (size_t i = 0; i < blocks; ++i) {
+        __m128i x = _mm_loadu_si128(reinterpret_cast<const __m128i*>(src + i * 16));
+        __m128i* dst = reinterpret_cast<__m128i*>(out + i * 16);
+        _mm_storeu_si128(dst + 0, _mm_unpacklo_epi8(x, zero));
+        _mm_storeu_si128(dst + 1, _mm_unpackhi_epi8(x, zero));
+    }
+    size_t done = blocks * 2;
+    UnpackFixed<8>(words + done, wordCount - done, out + done * 8, count - done * 8);
+}
+#elif defined(WI_UNPACK_NEON)
+static void UnpackSimd4(const uint64_t* words, size_t wordCount, uint16_t* out, size_t count) {
+    size_t blocks = std::min(wordCount / 2, count / 32);
+    const uint8x16_t lowMask = vdupq_n_u8(0x0F);
+    const uint8_t* src = reinterpret_cast<const uint8_t*>(words);
+    for (size_t i = 0; i < blocks; ++i) {
+        uint8x16_t x = vld1q_u8(src + i * 16);
+        uint8x16x2_t nibbles = vzipq_u8(vandq_u8(x, lowMask), vshrq_n_u8(x, 4));
+        uint16_t* dst = out + i * 32;
+        vst1q_u16(dst + 0, vmovl_u8(vget_low_u8(nibbles.val[0])));
+        vst1q_u16(dst + 8, vmovl_u8(vget_high_u8(nibbles.val[0])));
+        vst1q_u16(dst + 16, vmovl_u8(vget_low_u8(nibbles.val[1])));
+        vst1q_u16(dst + 24, vmovl_u8(vget_high_u8(nibbles.val[1])));
+    }
+    size_t done = blocks * 2;
+    UnpackFixed<4>(words + done, wordCount - done, out + done * 16, count - done * 16);
+}
+
+static void UnpackSimd8(const uint64_t* words, size_t wordCount, uint16_t* out, size_t count) {
+    size_t blocks = std::min(wordCount / 2, count / 16);
+    const uint8_t* src = reinterpret_cast<const uint8_t*>(words);
+    for (size_t i = 0; i < blocks; ++i) {
+        uint8x16_t x = vld1q_u8(src + i * 16);
+        vst1q_u16(out + i * 16, vmovl_u8(vget_low_u8(x)));
+        vst1q_u16(out + i * 16 + 8, vmovl_u8(vget_high_u8(x)));
+    }
+    size_t done = blocks * 2;
+    UnpackFixed<8>(words + done, wordCount - done, out + done * 8, count - done * 8);
+}
+#endif
+
+// --------------------------------------------------------------------------------
+// 按位宽分派
+// --------------------------------------------------------------------------------
+using UnpackKernel = void (*)(const uint64_t*, size_t, uint16_t*, size_t);
+
+// 下标为位宽，4..15 位各有一个特化内核
+static constexpr UnpackKernel Kernels[16] = {
+    nullptr, nullptr, nullptr, nullptr,
+#if defined(WI_UNPACK_SSE2) || defined(WI_UNPACK_NEON)
+    UnpackSimd4,
+#else
+    UnpackFixed<4>,
+#endif
+    UnpackFixed<5>, UnpackFixed<6>, UnpackFixed<7>,
+#if defined(WI_UNPACK_SSE2) || defined(WI_UNPACK_NEON)
+    UnpackSimd8,
+#else
+    UnpackFixed<8>,
+#endif
+    UnpackFixed<9>, UnpackFixed<10>, UnpackFixed<11>,
+    UnpackFixed<12>, UnpackFixed<13>, UnpackFixed<14>, UnpackFixed<15>
+};
+
+void UnpackPaletteIndices(const uint64_t* words, size_t wordCount, int bits, uint16_t* out, size_t count) {
+    if (bits >= 4 && bits <= 15) {
+        Kernels[bits](words, wordCount, out, count);
+    }
+    else if (bits >= 1 && bits <= 16) {
+        UnpackPaletteIndicesGeneric(words, wordCount, bits, out, count);
+    }
+    else {
+        std::fill(out, out + count, static_cast<uint16_t>(0));
+    }
+}
@@ -0,0 +1,25 @@
+// bitunpack.h
+#ifndef BITUNPACK_H
+#define BITUNPACK_H
+
+#include <cstddef>
+#include <cstdint>
+
+// 每个子区块的方块数
+constexpr int SectionVolume = 4096;
+
+// block_states 调色板大小对应的每条目位数：至少 4 位，否则为 ceil(log2(paletteSize))
+int BlockStateBits(size_t paletteSize);
+
+// 生物群系调色板大小对应的每条目位数：至少 1 位，否则为 ceil(log2(paletteSize))
+int BiomeBits(size_t paletteSize);
+
+// 把主机字节序的 long 数组解包为 count 个调色板下标写入 out
+// 每个 long 存放 64/bits 个条目，条目不跨 long（1.16+ 格式），words 不足时剩余下标填 0
+// 4..15 位使用按位宽特化的模板内核，4/8 位在 SSE2/NEON 上使用 SIMD 版本
+void UnpackPaletteIndices(const uint64_t* words, size_t wordCount, int bits, uint16_t* out, size_t count = SectionVolume);
+
+// 运行时位宽的通用实现（支持 1..16 位），供其他位宽使用及校验
+void UnpackPaletteIndicesGeneric(const uint64_t* words, size_t wordCount, int bits, uint16_t* out, size_t count = SectionVolume);
+
+#endif // BITUNPACK_H
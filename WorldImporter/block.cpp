@@ -8,9 +8,14 @@
 #include "model.h"
 #include "blockstate.h"
 #include "nbtutils.h"
+#include "NbtVisitor.h"
+#include "BlockStateRegistry.h"
+#include "byteswap.h"
+#include "bitunpack.h"
 #include "biome.h"
 #include "fileutils.h"
 #include "decompressor.h"
+#include "RegionFile.h"
 #include "coord_conversion.h"
 #include "config.h"
 #include <chrono>
@@ -19,42 +24,64 @@
 #include <codecvt>
 #include <random>
 #include <algorithm>  // added for find_if
+#include <shared_mutex>
+#include <mutex>
+#include <thread>
+#include <future>
+#include <atomic>
+#include <condition_variable>
+#include <array>
 
 using namespace std;
 
 
-// 自定义哈希函数，用于std::pair<int, int>
-struct pair_hash {
-    template <class T1, class T2>
-    std::size_t operator ()(const std::pair<T1, T2>& p) const {
-        auto h1 = std::hash<T1>{}(p.first);
-        auto h2 = std::hash<T2>{}(p.second);
-        return h1 ^ (h2 << 1);
-    }
-};
-
-// 自定义哈希函数，用于std::pair<int, int, int>
-struct triple_hash {
-    template <class T1, class T2, class T3>
-    std::size_t operator ()(const std::tuple<T1, T2, T3>& t) const {
-        auto h1 = std::hash<T1>{}(std::get<0>(t));
-        auto h2 = std::hash<T2>{}(std::get<1>(t));
-        auto h3 = std::hash<T3>{}(std::get<2>(t));
-        return h1 ^ (h2 << 1) ^ (h3 << 2);
-    }
-};
-
 // --------------------------------------------------------------------------------
 // 文件缓存相关对象
 // --------------------------------------------------------------------------------
 // 统一的缓存表
-std::unordered_map<std::tuple<int, int, int>, SectionCacheEntry, triple_hash> sectionCache;
-
-// 高度图缓存（键为 chunkX 和 chunkZ）
-std::unordered_map<std::pair<int, int>, std::vector<char>, pair_hash> regionCache;
-std::unordered_map<std::pair<int, int>, std::shared_ptr<NbtTag>, pair_hash> chunkCache;
-std::unordered_map<std::pair<int, int>, std::unordered_map<std::string, std::vector<int>>, pair_hash> heightMapCache;
+SectionStore sectionCache;
+
+// 区域文件缓存（键为 regionX、regionZ 的 Morton 键），每个区域文件只映射一次
+MortonMap<RegionFilePtr> regionCache;
+// 高度图缓存（键为 chunkX、chunkZ 的 Morton 键）
+MortonMap<std::unordered_map<std::string, std::vector<int>>> heightMapCache;
+// 缓存统计与 LRU 时钟（缓存只在主线程访问）
+CacheStats cacheStats;
+uint64_t cacheClock = 0;
+// 冻结期间缓存只读，允许多个网格生成线程同时查询
+static bool sectionCacheFrozen = false;
+// 暂停淘汰期间 EnforceCacheBudget 不做任何事，保证预取的子区块在网格生成前不会被换出
+static bool cacheEvictionSuspended = false;
 std::vector<Block> globalBlockPalette;
+std::vector<BlockStateInfo> blockStateInfos;
+const BlockStateInfo unknownBlockStateInfo = { 0, BLOCK_STATE_AIR, -1, "minecraft:air", "air", {} };
+// 方块命名空间名称，下标即 BlockStateInfo::namespaceId
+static std::vector<std::string> blockNamespaces = { "minecraft" };
+
+// 生成方块状态元数据（在驻留表写锁内调用，命名空间表无需另加锁）
+static BlockStateInfo MakeBlockStateInfo(const Block& block) {
+    BlockStateInfo info;
+    std::string namespaceName = block.GetNamespace();
+    auto it = std::find(blockNamespaces.begin(), blockNamespaces.end(), namespaceName);
+    if (it == blockNamespaces.end()) {
+        it = blockNamespaces.insert(blockNamespaces.end(), namespaceName);
+    }
+    info.namespaceId = static_cast<uint16_t>(it - blockNamespaces.begin());
+    info.name = block.GetModifiedNameWithNamespace();
+    info.key = block.GetModifiedName();
+    info.level = static_cast<int8_t>(block.level);
+    if (info.name == "minecraft:air") info.flags |= BLOCK_STATE_AIR;
+    if (!block.air) info.flags |= BLOCK_STATE_SOLID;
+    if (block.level >= 0) info.flags |= BLOCK_STATE_FLUID;
+    return info;
+}
+
+// 全局方块状态驻留表，供并行加载线程共享；新状态注册时同步追加到 globalBlockPalette 和 blockStateInfos
+// 注册表按顺序分配 ID，新 ID 总是等于追加前 globalBlockPalette 的长度
+BlockStateRegistry blockStateRegistry([](int /*id*/, const std::string& canonicalName) {
+    globalBlockPalette.emplace_back(canonicalName);
+    blockStateInfos.push_back(MakeBlockStateInfo(globalBlockPalette.back()));
+});
 std::unordered_set<std::string> solidBlocks;
 std::unordered_set<std::string> fluidBlocks = {
     "water",
@@ -63,15 +90,15 @@ std::unordered_set<std::string> fluidBlocks = {
 // --------------------------------------------------------------------------------
 // 文件操作相关函数
 // --------------------------------------------------------------------------------
-std::vector<int> decodeHeightMap(const std::vector<int64_t>& data) {
+// data 为主机字节序的 long 数组
+std::vector<int> decodeHeightMap(const HostLongBuffer& data) {
     // 根据数据长度自动判断存储格式
     int bitsPerEntry = (data.size() == 37) ? 9 : 8; // 主世界37个long用9bit，其他32个用8bit
     int entriesPerLong = 64 / bitsPerEntry;
     int mask = (1 << bitsPerEntry) - 1;
     std::vector<int> heights;
 
-    for (const auto& longVal : data) {
-        int64_t value = reverseEndian(longVal);
+    for (uint64_t value : data) {
         for (int i = 0; i < entriesPerLong; ++i) {
             int height = static_cast<int>((value >> (i * bitsPerEntry)) & mask);
             heights.push_back(height);
@@ -84,177 +111,266 @@ std::vector<int> decodeHeightMap(const std::vector<int64_t>& data) {
     return heights;
 }
 
-std::vector<char> GetChunkNBTData(const std::vector<char>& fileData, int x, int z) {
-    unsigned offset = CalculateOffset(fileData, mod32(x), mod32(z));
+bool GetChunkNBTData(const RegionFile& region, int x, int z, std::vector<char>& decompressedData) {
+    uint8_t compressionType = 0;
+    ByteSpan payload = region.GetChunkPayload(mod32(x), mod32(z), compressionType);
 
-    if (offset == 0) {
-        cerr << "错误: 偏移计算失败。" << endl;
-        return {};
+    // 超大区块存放在外部 .mcc 文件中，区域文件里只保留压缩类型
+    MappedFile externalFile;
+    if (compressionType & COMPRESSION_EXTERNAL) {
+        if (!region.OpenExternalChunk(mod32(x), mod32(z), externalFile)) {
+            return false;
+        }
+        payload = { externalFile.data(), externalFile.size() };
     }
 
-    unsigned length = ExtractChunkLength(fileData, offset);
-    if (offset + 5 <= fileData.size()) {
-        int startOffset = offset + 5;
-        int endIndex = startOffset + length - 1;
+    if (payload.empty()) {
+        cerr << "错误: 偏移计算失败。" << endl;
+        return false;
+    }
 
-        if (endIndex < fileData.size()) {
-            vector<char> chunkData(fileData.begin() + startOffset, fileData.begin() + endIndex + 1);
-            vector<char> decompressedData;
+    // 直接从映射视图解压，不再拷贝区块负载
+    if (!DecompressChunk(payload.data, payload.size, compressionType, decompressedData)) {
+        cerr << "错误: 解压失败。" << endl;
+        return false;
+    }
+    return true;
+}
 
-            if (DecompressData(chunkData, decompressedData)) {
-                return decompressedData;
-            } else {
-                cerr << "错误: 解压失败。" << endl;
-                return {};
-            }
-        } else {
-            cerr << "错误: 区块数据超出了文件边界。" << endl;
-            return {};
-        }
-    } else {
-        cerr << "错误: 从偏移位置读取5个字节的数据不够。" << endl;
+std::vector<char> GetChunkNBTData(const RegionFile& region, int x, int z) {
+    vector<char> decompressedData;
+    if (!GetChunkNBTData(region, x, z, decompressedData)) {
         return {};
     }
+    return decompressedData;
 }
 
-std::vector<char> getRegionFromCache(int regionX, int regionZ) {
+RegionFilePtr getRegionFromCache(int regionX, int regionZ) {
     // 创建区域缓存的键值
-    auto regionKey = std::make_pair(regionX, regionZ);
+    uint64_t regionKey = MortonKey2D(regionX, regionZ);
 
     // 检查区域是否已缓存
-    if (regionCache.find(regionKey) == regionCache.end()) {
-        // 若未缓存，从磁盘读取区域文件
-        std::vector<char> fileData = ReadFileToMemory(config.worldPath, regionX, regionZ);
-        // 将区域文件数据存入缓存
-        regionCache[regionKey] = fileData;
-        return regionCache[regionKey];
+    if (RegionFilePtr* cached = regionCache.find(regionKey)) {
+        ++cacheStats.regionHits;
+        return *cached;
     }
+    ++cacheStats.regionMisses;
 
-    // 返回缓存中的区域文件数据
-    return regionCache[regionKey];
+    // 若未缓存，映射区域文件；打开失败时同样缓存空对象，避免重复尝试
+    auto region = std::make_shared<RegionFile>(regionX, regionZ);
+    region->open(config.worldPath);
+    regionCache[regionKey] = region;
+    return region;
 }
 
-void UpdateSkyLightNeighborFlags() {
-    std::unordered_map<std::tuple<int, int, int>, bool, triple_hash> needsUpdate;
+uint32_t GetChunkTimestamp(int chunkX, int chunkZ) {
+    int regionX, regionZ;
+    chunkToRegion(chunkX, chunkZ, regionX, regionZ);
+    RegionFilePtr region = getRegionFromCache(regionX, regionZ);
+    if (!region->isOpen() || !region->HasChunk(mod32(chunkX), mod32(chunkZ))) {
+        return 0;
+    }
+    return region->GetHeader().GetEntry(mod32(chunkX), mod32(chunkZ)).timestamp;
+}
 
-    // 收集需要更新的区块
-    for (const auto& entry : sectionCache) {
-        const auto& key = entry.first;
-        const auto& skyLightData = entry.second.skyLight;
+// 每个发布过的子区块的天空光照标记（PRESENT/MISSING），子区块被淘汰后仍保留，
+// 使重新加载的子区块与其邻居得到与全部常驻时相同的相邻标记
+static MortonMap<uint8_t> publishedSkyLightFlags;
 
-        if (skyLightData.size() == 1 && skyLightData[0] == -1) {
-            needsUpdate[key] = true;
+// 缺少天空光照且任一相邻子区块（包括已被淘汰的）带有天空光照时标记为 -2
+static void RefreshSkyLightNeighborFlag(int chunkX, int chunkZ, int sectionY) {
+    SectionCacheEntry* entry = sectionCache.Find(chunkX, chunkZ, sectionY);
+    if (!entry || !(entry->lightFlags & SKY_LIGHT_MISSING) || (entry->lightFlags & SKY_LIGHT_NEIGHBOR)) {
+        return;
+    }
+
+    const int directions[6][3] = {
+        {chunkX + 1, chunkZ,   sectionY}, {chunkX - 1, chunkZ,   sectionY},
+        {chunkX,   chunkZ + 1, sectionY}, {chunkX,   chunkZ - 1, sectionY},
+        {chunkX,   chunkZ,   sectionY + 1}, {chunkX,   chunkZ,   sectionY - 1}
+    };
+    for (const auto& dir : directions) {
+        const uint8_t* flags = publishedSkyLightFlags.find(SectionKey(dir[0], dir[1], dir[2]));
+        if (flags && (*flags & SKY_LIGHT_PRESENT)) {
+            entry->lightFlags |= SKY_LIGHT_NEIGHBOR;
+            return;
         }
     }
+}
 
-    // 检查邻居
-    for (auto& entry : needsUpdate) {
-        int chunkX = std::get<0>(entry.first);
-        int chunkZ = std::get<1>(entry.first);
-        int sectionY = std::get<2>(entry.first);
-        bool hasLightNeighbor = false;
+void UpdateSkyLightNeighborFlags() {
+    sectionCache.ForEach([](int chunkX, int chunkZ, int sectionY, SectionCacheEntry&) {
+        RefreshSkyLightNeighborFlag(chunkX, chunkZ, sectionY);
+        });
+}
 
-        const std::vector<std::tuple<int, int, int>> directions = {
-            {chunkX + 1, chunkZ,   sectionY}, {chunkX - 1, chunkZ,   sectionY},
-            {chunkX,   chunkZ + 1, sectionY}, {chunkX,   chunkZ - 1, sectionY},
-            {chunkX,   chunkZ,   sectionY + 1}, {chunkX,   chunkZ,   sectionY - 1}
-        };
+// --------------------------------------------------------------------------------
+// 子区块存储
+// --------------------------------------------------------------------------------
+void SectionStore::SetBounds(int chunkXMin, int chunkXMax, int chunkZMin, int chunkZMax, int sectionYMin, int sectionYMax) {
+    ClearBounds();
+    if (chunkXMin > chunkXMax || chunkZMin > chunkZMax || sectionYMin > sectionYMax) {
+        return;
+    }
 
-        for (const auto& dir : directions) {
-            if (sectionCache.count(dir) && sectionCache[dir].skyLight.size() == 4096) {
-                hasLightNeighbor = true;
-                break;
-            }
+    // 稠密数组每个子区块只占一个指针，超过上限（32 MiB）时仍只用哈希表
+    const size_t maxCells = size_t(1) << 22;
+    size_t cells = static_cast<size_t>(chunkXMax - chunkXMin + 1) * static_cast<size_t>(chunkZMax - chunkZMin + 1) *
+        static_cast<size_t>(sectionYMax - sectionYMin + 1);
+    if (cells > maxCells) {
+        return;
+    }
+
+    minX = chunkXMin;
+    minZ = chunkZMin;
+    minY = sectionYMin;
+    sizeX = static_cast<unsigned>(chunkXMax - chunkXMin + 1);
+    sizeZ = static_cast<unsigned>(chunkZMax - chunkZMin + 1);
+    sizeY = static_cast<unsigned>(sectionYMax - sectionYMin + 1);
+    grid.assign(cells, nullptr);
+
+    // 已缓存的子区块补进数组
+    entries.forEach([this](uint64_t key, std::unique_ptr<SectionCacheEntry>& entry) {
+        int chunkX, chunkZ, sectionY;
+        DecodeSectionKey(key, chunkX, chunkZ, sectionY);
+        if (InGrid(chunkX, chunkZ, sectionY)) {
+            grid[GridIndex(chunkX, chunkZ, sectionY)] = entry.get();
         }
+        });
+}
 
-        if (hasLightNeighbor) {
-            auto& skyLightData = sectionCache[entry.first].skyLight;
-            skyLightData = std::vector<int>{ -2 };
+void SectionStore::ClearBounds() {
+    grid.clear();
+    grid.shrink_to_fit();
+    sizeX = sizeZ = sizeY = 0;
+}
+
+SectionCacheEntry& SectionStore::Emplace(int chunkX, int chunkZ, int sectionY) {
+    if (InGrid(chunkX, chunkZ, sectionY)) {
+        SectionCacheEntry*& cell = grid[GridIndex(chunkX, chunkZ, sectionY)];
+        if (cell) {
+            return *cell;
         }
+        std::unique_ptr<SectionCacheEntry>& entry = entries[SectionKey(chunkX, chunkZ, sectionY)];
+        entry = std::make_unique<SectionCacheEntry>();
+        cell = entry.get();
+        return *cell;
+    }
+
+    std::unique_ptr<SectionCacheEntry>& entry = entries[SectionKey(chunkX, chunkZ, sectionY)];
+    if (!entry) {
+        entry = std::make_unique<SectionCacheEntry>();
+    }
+    return *entry;
+}
+
+bool SectionStore::Erase(int chunkX, int chunkZ, int sectionY) {
+    if (!entries.erase(SectionKey(chunkX, chunkZ, sectionY))) {
+        return false;
     }
+    if (InGrid(chunkX, chunkZ, sectionY)) {
+        grid[GridIndex(chunkX, chunkZ, sectionY)] = nullptr;
+    }
+    return true;
+}
+
+void SectionStore::clear() {
+    entries.clear();
+    std::fill(grid.begin(), grid.end(), nullptr);
+}
+
+void SetSectionCacheBounds(int chunkXMin, int chunkXMax, int chunkZMin, int chunkZMax, int sectionYMin, int sectionYMax) {
+    sectionCache.SetBounds(chunkXMin, chunkXMax, chunkZMin, chunkZMax,
+        AdjustSectionY(sectionYMin), AdjustSectionY(sectionYMax));
 }
 
 // --------------------------------------------------------------------------------
 // 方块相关核心函数
 // --------------------------------------------------------------------------------
+int RegisterBlockName(const std::string& blockName) {
+    return blockStateRegistry.Intern(blockName);
+}
+
 void RegisterBlockPalette(const std::vector<std::string>& blockPalette) {
     for (const auto& blockName : blockPalette) {
-        if (find_if(globalBlockPalette.begin(), globalBlockPalette.end(), [&blockName](const Block& b) {
-            return b.name == blockName;
-            }) == globalBlockPalette.end()) {
-            globalBlockPalette.emplace_back(Block(blockName));
-        }
+        RegisterBlockName(blockName);
     }
 }
-// 新增函数：处理单个子区块
-void ProcessSection(int chunkX, int chunkZ, int sectionY, const NbtTagPtr& sectionTag) {
-    // 获取方块数据
-    auto blo = getBlockStates(sectionTag);
-    std::vector<std::string> blockPalette = getBlockPalette(blo);
-    std::vector<int> blockData = getBlockStatesData(blo, blockPalette);
-
-    // 转换为全局ID并注册调色板
-    std::vector<int> globalBlockData;
-    globalBlockData.reserve(blockData.size()); // 预分配空间
+// 方块名（不含属性）是否在 solidBlocks 中，与 Block::air 的判断一致
+static bool IsSolidBlockName(std::string_view name) {
+    thread_local std::string key;
+    key.assign(name);
+    return solidBlocks.find(key) != solidBlocks.end();
+}
 
-    static std::unordered_map<std::string, int> globalBlockMap; // 预处理全局调色板映射
+// 子区块解码所需的原始数据，由 ChunkVisitor 在一次遍历中收集，
+// 数组直接引用解压缓冲区
+struct SectionSource {
+    int sectionY = -1;
+    std::vector<int> blockPalette;      // 调色板条目的全局状态ID
+    std::vector<uint8_t> paletteOpaque; // 调色板条目是否为不透明方块
+    NbtArrayView<int64_t> blockStates;
+    bool hasBiomes = false;
+    std::vector<std::string> biomePalette;
+    NbtArrayView<int64_t> biomeStates;
+    bool hasSkyLight = false;
+    NbtArrayView<int8_t> skyLight;
+    bool hasBlockLight = false;
+    NbtArrayView<int8_t> blockLight;
+};
 
-    // 预处理全局调色板，建立快速查找的映射
-    if (globalBlockMap.empty()) {
-        for (size_t i = 0; i < globalBlockPalette.size(); ++i) {
-            const Block& block = globalBlockPalette[i];
-            if (globalBlockMap.find(block.name) == globalBlockMap.end()) {
-                globalBlockMap[block.name] = static_cast<int>(i);
-            }
+// 新增函数：解码单个子区块（不访问 sectionCache，可在工作线程中调用）
+SectionCacheEntry ProcessSection(SectionSource& source) {
+    // 调色板在遍历时已直接驻留为全局ID
+    const std::vector<int>& paletteToGlobal = source.blockPalette;
+
+    // 方块数据保持位压缩形式，只保存局部→全局ID表；同时生成不透明方块位集
+    const std::vector<uint8_t>& paletteOpaque = source.paletteOpaque;
+    PalettedContainer blocks;
+    OcclusionMask opaque;
+    if (source.blockStates.empty()) {
+        // 调色板只有一项时 data 缺省，整个子区块为同一种方块，只存一个ID
+        if (paletteToGlobal.size() == 1) {
+            blocks = PalettedContainer(paletteToGlobal[0]);
+            opaque.Fill(!paletteOpaque.empty() && paletteOpaque[0] != 0);
         }
     }
-
-    for (int relativeId : blockData) {
-        if (relativeId < 0 || relativeId >= static_cast<int>(blockPalette.size())) {
-            globalBlockData.push_back(0);
-            continue;
-        }
-
-        const std::string& blockName = blockPalette[relativeId];
-        auto it = globalBlockMap.find(blockName);
-        if (it != globalBlockMap.end()) {
-            globalBlockData.push_back(it->second);
+    else {
+        thread_local HostLongBuffer words;
+        source.blockStates.toHost(words);
+        int bits = BlockStateBits(paletteToGlobal.size());
+        blocks = PalettedContainer(paletteToGlobal, words.data(), words.size(), bits);
+        if (blocks.IsUniform()) {
+            // 调色板为空（损坏的区块）时 PalettedContainer 退化为空气
+            opaque.Fill(!paletteOpaque.empty() && paletteOpaque[0] != 0);
         }
         else {
-            int idx = static_cast<int>(globalBlockPalette.size());
-            globalBlockPalette.emplace_back(Block(blockName));
-            globalBlockMap[blockName] = idx;
-            globalBlockData.push_back(idx);
+            uint16_t indices[SectionVolume];
+            UnpackPaletteIndices(words.data(), words.size(), bits, indices);
+            for (int i = 0; i < SectionVolume; ++i) {
+                uint64_t bit = (indices[i] < paletteOpaque.size()) ? paletteOpaque[indices[i]] : 0;
+                opaque.words[i >> 6] |= bit << (i & 63);
+            }
         }
     }
 
     // 获取生物群系数据
-    auto bio = getBiomes(sectionTag);
     std::vector<int> biomeData;
-    if (bio) {
-        std::vector<std::string> biomePalette = getBiomePalette(bio);
-        auto dataTag = getChildByName(bio, "data");
+    if (source.hasBiomes) {
+        const std::vector<std::string>& biomePalette = source.biomePalette;
+        const NbtArrayView<int64_t>& longs = source.biomeStates;
 
-        if (dataTag && dataTag->type == TagType::LONG_ARRAY) {
+        if (!longs.empty()) {
             int paletteSize = biomePalette.size();
-            int bitsPerEntry = (paletteSize > 1) ? static_cast<int>(std::ceil(std::log2(paletteSize))) : 1;
-            int entriesPerLong = 64 / bitsPerEntry; // 每个long存储多少个条目
-            int mask = (1 << bitsPerEntry) - 1;
-
             biomeData.resize(64, 0); // 固定64个生物群系单元
-            int totalProcessed = 0;
-
-            const int64_t* data = reinterpret_cast<const int64_t*>(dataTag->payload.data());
-            size_t dataSize = dataTag->payload.size() / sizeof(int64_t);
-
-            for (size_t i = 0; i < dataSize && totalProcessed < 64; ++i) {
-                int64_t value = reverseEndian(data[i]);
-                for (int pos = 0; pos < entriesPerLong && totalProcessed < 64; ++pos) {
-                    int index = (value >> (pos * bitsPerEntry)) & mask;
-                    if (index < paletteSize) {
-                        biomeData[totalProcessed] = Biome::GetId(biomePalette[index]);
-                    }
-                    totalProcessed++;
+
+            thread_local HostLongBuffer words;
+            longs.toHost(words);
+            uint16_t indices[64];
+            UnpackPaletteIndices(words.data(), words.size(), BiomeBits(paletteSize), indices, 64);
+            for (int i = 0; i < 64; ++i) {
+                if (indices[i] < paletteSize) {
+                    biomeData[i] = Biome::GetId(biomePalette[indices[i]]);
                 }
             }
         }
@@ -264,98 +380,473 @@ void ProcessSection(int chunkX, int chunkZ, int sectionY, const NbtTagPtr& secti
         }
     }
 
-    // 获取光照数据
-    auto processLightData = [&](const std::string& lightType, std::vector<int>& lightData) {
-        auto lightTag = getChildByName(sectionTag, lightType);
-        if (lightTag && lightTag->type == TagType::BYTE_ARRAY) {
-            const std::vector<char>& rawData = lightTag->payload;
-            lightData.resize(4096, 0);
-            int rawDataSize = rawData.size();
+    // 光照保持存档中的 2048 字节格式，关闭 decodeLight 时只记录是否存在
+    SectionCacheEntry entry;
+    entry.blocks = std::move(blocks);
+    entry.opaque = opaque;
+    entry.biomeData = std::move(biomeData);
+    if (source.hasSkyLight) {
+        entry.lightFlags |= SKY_LIGHT_PRESENT;
+        if (config.decodeLight) {
+            entry.skyLight.Assign(source.skyLight.data(), source.skyLight.size());
+        }
+    }
+    else {
+        entry.lightFlags |= SKY_LIGHT_MISSING;
+    }
+    if (source.hasBlockLight) {
+        entry.lightFlags |= BLOCK_LIGHT_PRESENT;
+        if (config.decodeLight) {
+            entry.blockLight.Assign(source.blockLight.data(), source.blockLight.size());
+        }
+    }
+    else {
+        entry.lightFlags |= BLOCK_LIGHT_MISSING;
+    }
+    return entry;
+}
 
-            for (int yzx = 0; yzx < 4096; ++yzx) {
-                int byteIndex = yzx >> 1;
-                if (byteIndex >= rawDataSize) {
-                    lightData[yzx] = 0;
-                    continue;
-                }
-                uint8_t byteVal = static_cast<uint8_t>(rawData[byteIndex]);
-                lightData[yzx] = (yzx & 1) ? (byteVal >> 4) & 0xF : byteVal & 0xF;
-            }
+// 区块解码访问器：只进入高度图和子区块中的方块、群系与光照，
+// block_entities、structures、PostProcessing 等容器按长度跳过。
+// 每个子区块在其 TAG_Compound 结束时立即解码，整个区块只遍历一次且不构建节点
+class ChunkVisitor : public NbtVisitor {
+public:
+    explicit ChunkVisitor(DecodedChunk& out) : out(out) {}
+
+    Action onCompoundBegin(std::string_view name) override {
+        Context top = Top();
+        if (depth == 0) return Push(Context::Root);
+        if (top == Context::Root && name == "Heightmaps") return Push(Context::Heightmaps);
+        if (top == Context::Sections) {
+            section = SectionSource();
+            return Push(Context::Section);
         }
-        else {
-            lightData = { -1 };
+        if (top == Context::Section && name == "block_states") return Push(Context::BlockStates);
+        if (top == Context::Section && name == "biomes") {
+            section.hasBiomes = true;
+            return Push(Context::Biomes);
         }
-        };
+        if (top == Context::BlockPalette) {
+            entryName = std::string_view();
+            entryProperties.clear();
+            return Push(Context::PaletteEntry);
+        }
+        if (top == Context::PaletteEntry && name == "Properties") return Push(Context::Properties);
+        return Action::Skip;
+    }
 
-    std::vector<int> skyLightData;
-    processLightData("SkyLight", skyLightData);
-    std::vector<int> blockLightData;
-    processLightData("BlockLight", blockLightData);
+    Action onCompoundEnd() override {
+        Context closed = stack[--depth];
+        if (closed == Context::Section) {
+            out.sections.emplace_back(AdjustSectionY(section.sectionY), ProcessSection(section));
+        }
+        else if (closed == Context::PaletteEntry) {
+            // 方块名与属性视图直接驻留为全局ID，不拼接中间字符串
+            section.blockPalette.push_back(
+                blockStateRegistry.Intern(entryName, entryProperties.data(), entryProperties.size()));
+            section.paletteOpaque.push_back(IsSolidBlockName(entryName) ? 1 : 0);
+        }
+        return Action::Continue;
+    }
 
-    // 存储到统一的缓存
-    int adjustedSectionY = AdjustSectionY(sectionY);
-    auto blockKey = std::make_tuple(chunkX, chunkZ, adjustedSectionY);
-    sectionCache[blockKey] = {
-        std::move(skyLightData), // 使用 move 语义减少拷贝开销
-        std::move(blockLightData),
-        std::move(blockPalette),
-        std::move(globalBlockData),
-        std::move(biomeData)
+    Action onListBegin(std::string_view name, TagType elementType, size_t length) override {
+        Context top = Top();
+        if (top == Context::Root && name == "sections" && elementType == TagType::COMPOUND) {
+            out.sections.reserve(length);
+            return Push(Context::Sections);
+        }
+        if (top == Context::BlockStates && name == "palette" && elementType == TagType::COMPOUND) {
+            section.blockPalette.reserve(length);
+            section.paletteOpaque.reserve(length);
+            return Push(Context::BlockPalette);
+        }
+        if (top == Context::Biomes && name == "palette" && elementType == TagType::STRING) {
+            section.biomePalette.reserve(length);
+            return Push(Context::BiomePalette);
+        }
+        return Action::Skip;
+    }
+
+    Action onListEnd() override {
+        --depth;
+        return Action::Continue;
+    }
+
+    Action onByte(std::string_view name, int8_t value) override {
+        if (Top() == Context::Section && name == "Y") {
+            section.sectionY = value;
+        }
+        return Action::Continue;
+    }
+
+    Action onString(std::string_view name, std::string_view value) override {
+        switch (Top()) {
+        case Context::PaletteEntry:
+            if (name == "Name") entryName = value;
+            break;
+        case Context::Properties:
+            entryProperties.push_back({ name, value });
+            break;
+        case Context::BiomePalette:
+            section.biomePalette.emplace_back(value);
+            break;
+        default:
+            break;
+        }
+        return Action::Continue;
+    }
+
+    Action onLongArray(std::string_view name, NbtArrayView<int64_t> values) override {
+        switch (Top()) {
+        case Context::Heightmaps:
+            DecodeHeightMapArray(name, values);
+            break;
+        case Context::BlockStates:
+            if (name == "data") section.blockStates = values;
+            break;
+        case Context::Biomes:
+            if (name == "data") section.biomeStates = values;
+            break;
+        default:
+            break;
+        }
+        return Action::Continue;
+    }
+
+    Action onByteArray(std::string_view name, NbtArrayView<int8_t> values) override {
+        if (Top() == Context::Section) {
+            if (name == "SkyLight") {
+                section.hasSkyLight = true;
+                section.skyLight = values;
+            }
+            else if (name == "BlockLight") {
+                section.hasBlockLight = true;
+                section.blockLight = values;
+            }
+        }
+        return Action::Continue;
+    }
+
+private:
+    enum class Context : uint8_t {
+        None, Root, Heightmaps, Sections, Section,
+        BlockStates, BlockPalette, PaletteEntry, Properties, Biomes, BiomePalette
     };
+
+    Context Top() const { return depth > 0 ? stack[depth - 1] : Context::None; }
+
+    Action Push(Context context) {
+        if (depth >= static_cast<int>(stack.size())) return Action::Skip;
+        stack[depth++] = context;
+        return Action::Continue;
+    }
+
+    void DecodeHeightMapArray(std::string_view name, const NbtArrayView<int64_t>& values) {
+        static const char* const mapTypes[] = {
+            "MOTION_BLOCKING", "MOTION_BLOCKING_NO_LEAVES",
+            "OCEAN_FLOOR", "WORLD_SURFACE"
+        };
+        for (const char* mapType : mapTypes) {
+            if (name == mapType && !values.empty()) {
+                thread_local HostLongBuffer words;
+                values.toHost(words);
+                out.heightMaps[mapType] = decodeHeightMap(words);
+                return;
+            }
+        }
+    }
+
+    DecodedChunk& out;
+    std::array<Context, 8> stack{};
+    int depth = 0;
+    SectionSource section;
+    std::string_view entryName;                         // 视图指向解压缓冲区
+    std::vector<BlockStateProperty> entryProperties;
+};
+
+bool DecodeChunk(const RegionFile& region, int chunkX, int chunkZ, DecodedChunk& out) {
+    out.chunkX = chunkX;
+    out.chunkZ = chunkZ;
+
+    // 解压缓冲区按线程复用，访问器回调中的视图直接引用解压缓冲区
+    thread_local std::vector<char> chunkData;
+    if (!GetChunkNBTData(region, mod32(chunkX), mod32(chunkZ), chunkData)) {
+        return false;
+    }
+
+    ChunkVisitor visitor(out);
+    VisitNbt(chunkData.data(), chunkData.size(), visitor);
+    return true;
+}
+
+// 估算子区块缓存占用的内存
+static size_t EstimateSectionBytes(const SectionCacheEntry& entry) {
+    size_t bytes = sizeof(SectionCacheEntry) - sizeof(PalettedContainer) + entry.blocks.MemoryBytes();
+    bytes += entry.skyLight.MemoryBytes() + entry.blockLight.MemoryBytes() + entry.biomeData.capacity() * sizeof(int);
+    return bytes;
+}
+
+void PublishDecodedChunk(DecodedChunk& chunk) {
+    if (!chunk.heightMaps.empty()) {
+        auto& heightMaps = heightMapCache[MortonKey2D(chunk.chunkX, chunk.chunkZ)];
+        for (auto& heightMap : chunk.heightMaps) {
+            heightMaps[heightMap.first] = std::move(heightMap.second);
+        }
+    }
+    for (auto& section : chunk.sections) {
+        SectionCacheEntry& entry = sectionCache.Emplace(chunk.chunkX, chunk.chunkZ, section.first);
+        cacheStats.sectionBytes -= entry.bytes;
+        entry = std::move(section.second);
+        entry.bytes = EstimateSectionBytes(entry);
+        entry.lastUse = ++cacheClock;
+        cacheStats.sectionBytes += entry.bytes;
+        publishedSkyLightFlags[SectionKey(chunk.chunkX, chunk.chunkZ, section.first)] =
+            entry.lightFlags & (SKY_LIGHT_PRESENT | SKY_LIGHT_MISSING);
+    }
+    // 相邻标记在发布时维护：新子区块自身及其六个邻居都要重新判断
+    for (const auto& section : chunk.sections) {
+        RefreshSkyLightNeighborFlag(chunk.chunkX, chunk.chunkZ, section.first);
+        RefreshSkyLightNeighborFlag(chunk.chunkX + 1, chunk.chunkZ, section.first);
+        RefreshSkyLightNeighborFlag(chunk.chunkX - 1, chunk.chunkZ, section.first);
+        RefreshSkyLightNeighborFlag(chunk.chunkX, chunk.chunkZ + 1, section.first);
+        RefreshSkyLightNeighborFlag(chunk.chunkX, chunk.chunkZ - 1, section.first);
+        RefreshSkyLightNeighborFlag(chunk.chunkX, chunk.chunkZ, section.first + 1);
+        RefreshSkyLightNeighborFlag(chunk.chunkX, chunk.chunkZ, section.first - 1);
+    }
+    cacheStats.peakSectionBytes = std::max(cacheStats.peakSectionBytes, cacheStats.sectionBytes);
+    EnforceCacheBudget();
 }
+
 // 修改 LoadAndCacheBlockData，使其处理整个 chunk 的所有子区块
 void LoadAndCacheBlockData(int chunkX, int chunkZ) {
     // 计算区域坐标
     int regionX, regionZ;
     chunkToRegion(chunkX, chunkZ, regionX, regionZ);
 
-    // 获取区域数据
-    std::vector<char> regionData = getRegionFromCache(regionX, regionZ);
-
-    // 获取区块数据
-    std::vector<char> chunkData = GetChunkNBTData(regionData, mod32(chunkX), mod32(chunkZ));
-    size_t index = 0;
-    auto tag = readTag(chunkData, index);
-    
-    // 处理高度图
-    auto heightMapsTag = getChildByName(tag, "Heightmaps");
-    if (heightMapsTag && heightMapsTag->type == TagType::COMPOUND) {
-        std::vector<std::string> mapTypes = {
-            "MOTION_BLOCKING", "MOTION_BLOCKING_NO_LEAVES",
-            "OCEAN_FLOOR", "WORLD_SURFACE"
-        };
+    // 获取区域数据（共享映射，不拷贝）
+    RegionFilePtr region = getRegionFromCache(regionX, regionZ);
+    if (!region->isOpen() || !region->HasChunk(mod32(chunkX), mod32(chunkZ))) {
+        return; // 区域文件缺失或区块未生成，直接查位图跳过
+    }
+
+    DecodedChunk chunk;
+    if (DecodeChunk(*region, chunkX, chunkZ, chunk)) {
+        PublishDecodedChunk(chunk);
+    }
+}
+
+// 已解码区块中不存在的子区块插入空条目（与 AcquireSection 未命中时相同），
+// 之后访问这些子区块不会再次在主线程解码整个区块
+static void CacheMissingSections(int chunkX, int chunkZ, int adjustedSectionYMin, int adjustedSectionYMax) {
+    for (int adjustedSectionY = adjustedSectionYMin; adjustedSectionY <= adjustedSectionYMax; ++adjustedSectionY) {
+        if (!sectionCache.Find(chunkX, chunkZ, adjustedSectionY)) {
+            SectionCacheEntry& entry = sectionCache.Emplace(chunkX, chunkZ, adjustedSectionY);
+            entry.bytes = EstimateSectionBytes(entry);
+            entry.lastUse = ++cacheClock;
+            cacheStats.sectionBytes += entry.bytes;
+        }
+    }
+}
 
-        for (const auto& mapType : mapTypes) {
-            auto mapDataTag = getChildByName(heightMapsTag, mapType);
-            if (mapDataTag && mapDataTag->type == TagType::LONG_ARRAY) {
-                size_t numLongs = mapDataTag->payload.size() / sizeof(int64_t);
-                const int64_t* rawData = reinterpret_cast<const int64_t*>(mapDataTag->payload.data());
-                std::vector<int64_t> longData(rawData, rawData + numLongs);
+void LoadChunksParallel(const std::vector<std::pair<int, int>>& chunks, int adjustedSectionYMin, int adjustedSectionYMax) {
+    // 在主线程解析区域文件（regionCache 不是线程安全的），工作线程只读共享映射
+    struct ChunkTask {
+        RegionFilePtr region;
+        int chunkX;
+        int chunkZ;
+    };
+    std::vector<ChunkTask> tasks;
+    tasks.reserve(chunks.size());
+    for (const auto& chunk : chunks) {
+        int regionX, regionZ;
+        chunkToRegion(chunk.first, chunk.second, regionX, regionZ);
+        RegionFilePtr region = getRegionFromCache(regionX, regionZ);
+        if (region->isOpen() && region->HasChunk(mod32(chunk.first), mod32(chunk.second))) {
+            tasks.push_back({ region, chunk.first, chunk.second });
+        }
+    }
+    if (tasks.empty()) {
+        return;
+    }
 
-                std::vector<int> heights = decodeHeightMap(longData);
-                heightMapCache[std::make_pair(chunkX, chunkZ)][mapType] = heights;
+    // 工作线程函数：按顺序领取任务，解码结果交给主线程边完成边合并
+    std::mutex readyMutex;
+    std::condition_variable readyCondition;
+    std::vector<DecodedChunk> ready;
+    size_t finishedTasks = 0;
+    std::atomic<size_t> nextTask{ 0 };
+    auto worker = [&]() {
+        while (true) {
+            size_t taskIndex = nextTask.fetch_add(1);
+            if (taskIndex >= tasks.size()) break;
+
+            const ChunkTask& task = tasks[taskIndex];
+            DecodedChunk chunk;
+            bool decoded = false;
+            try {
+                decoded = DecodeChunk(*task.region, task.chunkX, task.chunkZ, chunk);
+            }
+            catch (const std::exception& e) {
+                std::cerr << "错误: 区块 (" << task.chunkX << ", " << task.chunkZ << ") 解码失败: " << e.what() << std::endl;
             }
+            {
+                std::lock_guard<std::mutex> lock(readyMutex);
+                if (decoded) {
+                    ready.push_back(std::move(chunk));
+                }
+                ++finishedTasks;
+            }
+            readyCondition.notify_one();
         }
+        };
+
+    // 根据硬件并发数创建线程池
+    const size_t numThreads = std::min<size_t>(tasks.size(), std::max<unsigned>(1, std::thread::hardware_concurrency()));
+    std::vector<std::future<void>> futures;
+    for (size_t i = 0; i < numThreads; ++i) {
+        futures.emplace_back(std::async(std::launch::async, worker));
     }
 
-    // 提取所有子区块
-    auto sectionsTag = getChildByName(tag, "sections");
-    if (!sectionsTag || sectionsTag->type != TagType::LIST) {
-        return; // 没有子区块
+    // 主线程随解码进度合并到全局缓存，每次合并都按预算淘汰，
+    // 未合并的解码结果最多是各线程正在处理的少量区块
+    std::vector<DecodedChunk> publishing;
+    while (true) {
+        {
+            std::unique_lock<std::mutex> lock(readyMutex);
+            readyCondition.wait(lock, [&]() { return !ready.empty() || finishedTasks == tasks.size(); });
+            if (ready.empty()) break;
+            publishing.swap(ready);
+        }
+        for (auto& chunk : publishing) {
+            PublishDecodedChunk(chunk);
+            CacheMissingSections(chunk.chunkX, chunk.chunkZ, adjustedSectionYMin, adjustedSectionYMax);
+        }
+        publishing.clear();
     }
 
-    // 遍历所有子区块
-    for (const auto& sectionTag : sectionsTag->children) {
-        int sectionY = -1;
-        auto yTag = getChildByName(sectionTag, "Y");
-        
-        if (yTag && yTag->type == TagType::BYTE) {
-            sectionY = static_cast<int>(yTag->payload[0]);
+    for (auto& f : futures) {
+        try {
+            f.get();
+        }
+        catch (const std::exception& e) {
+            std::cerr << "Thread error: " << e.what() << std::endl;
         }
+    }
+}
 
-        // 处理子区块
-        ProcessSection(chunkX, chunkZ, sectionY, sectionTag);
+bool IsChunkCached(int chunkX, int chunkZ, int adjustedSectionYMin, int adjustedSectionYMax) {
+    for (int adjustedSectionY = adjustedSectionYMin; adjustedSectionY <= adjustedSectionYMax; ++adjustedSectionY) {
+        if (!sectionCache.Find(chunkX, chunkZ, adjustedSectionY)) {
+            return false;
+        }
     }
+    return true;
+}
+
+// --------------------------------------------------------------------------------
+// 缓存预算与淘汰
+// --------------------------------------------------------------------------------
+SectionCacheEntry& AcquireSection(int chunkX, int chunkZ, int adjustedSectionY) {
+    SectionCacheEntry* entry = sectionCache.Find(chunkX, chunkZ, adjustedSectionY);
+    if (sectionCacheFrozen) {
+        // 只读模式：不加载、不计数、不更新 LRU，未预取的子区块按不存在处理
+        static SectionCacheEntry missingSection;
+        return entry ? *entry : missingSection;
+    }
+    if (entry) {
+        ++cacheStats.sectionHits;
+    }
+    else {
+        ++cacheStats.sectionMisses;
+        LoadAndCacheBlockData(chunkX, chunkZ);
+        // 区块不存在时插入空条目，避免重复加载
+        entry = &sectionCache.Emplace(chunkX, chunkZ, adjustedSectionY);
+    }
+    entry->lastUse = ++cacheClock;
+    return *entry;
+}
+
+void FreezeSectionCache(bool frozen) {
+    sectionCacheFrozen = frozen;
+}
+
+void SuspendCacheEviction(bool suspended) {
+    cacheEvictionSuspended = suspended;
+    if (!suspended) {
+        EnforceCacheBudget();
+    }
+}
+
+void EnforceCacheBudget() {
+    if (config.cacheBudgetMB <= 0 || cacheEvictionSuspended) {
+        return;
+    }
+    const size_t budget = static_cast<size_t>(config.cacheBudgetMB) * 1024 * 1024;
+    if (cacheStats.sectionBytes <= budget) {
+        return;
+    }
+
+    // 一次淘汰到预算的 90%，避免每次发布都重新排序
+    const size_t target = budget / 10 * 9;
+    struct Candidate {
+        uint64_t lastUse;
+        size_t bytes;
+        int chunkX, chunkZ, sectionY;
+    };
+    std::vector<Candidate> candidates;
+    candidates.reserve(sectionCache.size());
+    sectionCache.ForEach([&candidates](int chunkX, int chunkZ, int sectionY, const SectionCacheEntry& entry) {
+        candidates.push_back({ entry.lastUse, entry.bytes, chunkX, chunkZ, sectionY });
+        });
+    std::sort(candidates.begin(), candidates.end(), [](const Candidate& a, const Candidate& b) {
+        return a.lastUse < b.lastUse;
+        });
+
+    for (const auto& candidate : candidates) {
+        if (cacheStats.sectionBytes <= target) break;
+        sectionCache.Erase(candidate.chunkX, candidate.chunkZ, candidate.sectionY);
+        cacheStats.sectionBytes -= candidate.bytes;
+        ++cacheStats.sectionEvictions;
+    }
+}
+
+void EvictChunk(int chunkX, int chunkZ) {
+    for (int adjustedSectionY = 0; adjustedSectionY < 128; ++adjustedSectionY) {
+        const SectionCacheEntry* entry = sectionCache.Find(chunkX, chunkZ, adjustedSectionY);
+        if (entry) {
+            cacheStats.sectionBytes -= entry->bytes;
+            sectionCache.Erase(chunkX, chunkZ, adjustedSectionY);
+            ++cacheStats.sectionEvictions;
+        }
+    }
+    if (heightMapCache.erase(MortonKey2D(chunkX, chunkZ))) {
+        ++cacheStats.heightMapEvictions;
+    }
+}
+
+void EvictRegion(int regionX, int regionZ) {
+    uint64_t regionKey = MortonKey2D(regionX, regionZ);
+    const RegionFilePtr* region = regionCache.find(regionKey);
+    // 打开失败的区域保留在缓存中，避免重复尝试
+    if (region && (*region)->isOpen()) {
+        regionCache.erase(regionKey);
+        ++cacheStats.regionEvictions;
+    }
+}
+
+const CacheStats& GetCacheStats() {
+    return cacheStats;
+}
+
+void PrintCacheStats() {
+    cout << "缓存统计:\n"
+        << " - 子区块 命中/未命中/淘汰: " << cacheStats.sectionHits << " / "
+        << cacheStats.sectionMisses << " / " << cacheStats.sectionEvictions << "\n"
+        << " - 区域文件 命中/未命中/淘汰: " << cacheStats.regionHits << " / "
+        << cacheStats.regionMisses << " / " << cacheStats.regionEvictions << "\n"
+        << " - 高度图淘汰: " << cacheStats.heightMapEvictions << "\n"
+        << " - 子区块内存 当前/峰值: " << cacheStats.sectionBytes / (1024 * 1024) << " MB / "
+        << cacheStats.peakSectionBytes / (1024 * 1024) << " MB" << endl;
 }
 
 // --------------------------------------------------------------------------------
@@ -369,19 +860,25 @@ int GetBlockId(int blockX, int blockY, int blockZ) {
     int sectionY;
     blockYToSectionY(blockY, sectionY);
     int adjustedSectionY = AdjustSectionY(sectionY);
-    auto blockKey = std::make_tuple(chunkX, chunkZ, adjustedSectionY);
 
-    if (sectionCache.find(blockKey) == sectionCache.end()) {
-        LoadAndCacheBlockData(chunkX, chunkZ);
+    const PalettedContainer& blocks = AcquireSection(chunkX, chunkZ, adjustedSectionY).blocks;
+    if (blocks.IsUniform()) {
+        return blocks.UniformId(); // 均匀或不存在的子区块
     }
 
-    const auto& blockData = sectionCache[blockKey].blockData;
     int relativeX = mod16(blockX);
     int relativeY = mod16(blockY);
     int relativeZ = mod16(blockZ);
-    int yzx = toYZX(relativeX, relativeY, relativeZ);
+    return blocks.Get(toYZX(relativeX, relativeY, relativeZ));
+}
 
-    return (yzx < blockData.size()) ? blockData[yzx] : 0;
+bool IsSectionUniform(int chunkX, int chunkZ, int sectionY, int& blockId) {
+    const PalettedContainer& blocks = AcquireSection(chunkX, chunkZ, AdjustSectionY(sectionY)).blocks;
+    if (!blocks.IsUniform()) {
+        return false;
+    }
+    blockId = blocks.UniformId();
+    return true;
 }
 
 // 获取天空光照
@@ -392,23 +889,21 @@ int GetSkyLight(int blockX, int blockY, int blockZ) {
     int sectionY;
     blockYToSectionY(blockY, sectionY);
     int adjustedSectionY = AdjustSectionY(sectionY);
-    auto blockKey = std::make_tuple(chunkX, chunkZ, adjustedSectionY);
-
-    if (sectionCache.find(blockKey) == sectionCache.end()) {
-        LoadAndCacheBlockData(chunkX, chunkZ);
-    }
-
-    const auto& skyLightData = sectionCache[blockKey].skyLight;
-    if (skyLightData.size() == 1) {
-        return skyLightData[0]; // 标记为-1或-2
-    }
 
     int relativeX = mod16(blockX);
     int relativeY = mod16(blockY);
     int relativeZ = mod16(blockZ);
-    int yzx = toYZX(relativeX, relativeY, relativeZ);
+    return GetSectionSkyLight(AcquireSection(chunkX, chunkZ, adjustedSectionY), toYZX(relativeX, relativeY, relativeZ));
+}
 
-    return (yzx < skyLightData.size()) ? skyLightData[yzx] : 0;
+int GetSectionSkyLight(const SectionCacheEntry& section, int yzx) {
+    if (section.lightFlags & SKY_LIGHT_NEIGHBOR) {
+        return -2;
+    }
+    if (section.skyLight.empty()) {
+        return (section.lightFlags & SKY_LIGHT_MISSING) ? -1 : 0; // 未解码或子区块不存在时为 0
+    }
+    return section.skyLight.Get(yzx);
 }
 
 int GetBlockLight(int blockX, int blockY, int blockZ) {
@@ -418,23 +913,18 @@ int GetBlockLight(int blockX, int blockY, int blockZ) {
     int sectionY;
     blockYToSectionY(blockY, sectionY);
     int adjustedSectionY = AdjustSectionY(sectionY);
-    auto blockKey = std::make_tuple(chunkX, chunkZ, adjustedSectionY);
-
-    if (sectionCache.find(blockKey) == sectionCache.end()) {
-        LoadAndCacheBlockData(chunkX, chunkZ);
-    }
-
-    const auto& blockLightData = sectionCache[blockKey].blockLight;
-    if (blockLightData.size() == 1) {
-        return blockLightData[0]; // 标记为-1或-2
-    }
 
     int relativeX = mod16(blockX);
     int relativeY = mod16(blockY);
     int relativeZ = mod16(blockZ);
-    int yzx = toYZX(relativeX, relativeY, relativeZ);
+    return GetSectionBlockLight(AcquireSection(chunkX, chunkZ, adjustedSectionY), toYZX(relativeX, relativeY, relativeZ));
+}
 
-    return (yzx < blockLightData.size()) ? blockLightData[yzx] : 0;
+int GetSectionBlockLight(const SectionCacheEntry& section, int yzx) {
+    if (section.blockLight.empty()) {
+        return (section.lightFlags & BLOCK_LIGHT_MISSING) ? -1 : 0; // 未解码或子区块不存在时为 0
+    }
+    return section.blockLight.Get(yzx);
 }
 // --------------------------------------------------------------------------------
 // 方块扩展信息查询函数
@@ -447,29 +937,21 @@ Block GetBlockById(int blockId) {
     }
 }
 
-std::string GetBlockNameById(int blockId) {
-    if (blockId >= 0 && blockId < globalBlockPalette.size()) {
-        return globalBlockPalette[blockId].GetModifiedNameWithNamespace();
-    } else {
-        return "minecraft:air";
-    }
+const std::string& GetBlockNameById(int blockId) {
+    return GetBlockStateInfo(blockId).name;
 }
 
-std::string GetBlockNamespaceById(int blockId) {
-    if (blockId >= 0 && blockId < globalBlockPalette.size()) {
-        return globalBlockPalette[blockId].GetNamespace();
-    }
-    else {
-        return "minecraft";
-    }
+const std::string& GetBlockNamespaceById(int blockId) {
+    return GetNamespaceName(GetBlockStateInfo(blockId).namespaceId);
+}
+
+const std::string& GetNamespaceName(uint16_t namespaceId) {
+    return namespaceId < blockNamespaces.size() ? blockNamespaces[namespaceId] : blockNamespaces[0];
 }
 
 // 获取方块ID时同时获取相邻方块的air状态，返回当前方块ID
 int GetBlockIdWithNeighbors(int blockX, int blockY, int blockZ, bool* neighborIsAir) {
-    int currentId = GetBlockId(blockX, blockY, blockZ);
-    Block currentBlock = GetBlockById(currentId);
-
-    const std::vector<std::tuple<int, int, int>> directions = {
+    static const int directions[6][3] = {
         {0, 1, 0},  // 上（Y+）
         {0, -1, 0}, // 下（Y-）
         {-1, 0, 0}, // 西（X-）
@@ -479,24 +961,11 @@ int GetBlockIdWithNeighbors(int blockX, int blockY, int blockZ, bool* neighborIs
     };
 
     for (int i = 0; i < 6; ++i) {
-        int dx, dy, dz;
-        tie(dx, dy, dz) = directions[i];
-
-        int nx = blockX + dx;
-        int ny = blockY + dy;
-        int nz = blockZ + dz;
-
-        //if (ny < -64 || ny > 255) {
-        //    neighborIsAir[i] = (ny < -64); // 地下视为非空气（可选）
-        //    continue;
-        //}
-
-        int neighborId = GetBlockId(nx, ny, nz);
-        Block neighborBlock = GetBlockById(neighborId);
-        neighborIsAir[i] = neighborBlock.air;
+        int neighborId = GetBlockId(blockX + directions[i][0], blockY + directions[i][1], blockZ + directions[i][2]);
+        neighborIsAir[i] = !(GetBlockStateInfo(neighborId).flags & BLOCK_STATE_SOLID);
     }
 
-    return currentId;
+    return GetBlockId(blockX, blockY, blockZ);
 }
 
 int GetHeightMapY(int blockX, int blockZ, const std::string& heightMapType) {
@@ -508,16 +977,14 @@ int GetHeightMapY(int blockX, int blockZ, const std::string& heightMapType) {
     GetBlockId(blockX, 0, blockZ); // Y坐标任意，只为触发加载
 
     // 查找缓存
-    auto chunkKey = std::make_pair(chunkX, chunkZ);
-    auto chunkIter = heightMapCache.find(chunkKey);
-    if (chunkIter == heightMapCache.end()) {
+    const auto* typeMap = heightMapCache.find(MortonKey2D(chunkX, chunkZ));
+    if (!typeMap) {
         return -1; // 区块未加载
     }
 
     // 获取指定类型的高度图
-    auto& typeMap = chunkIter->second;
-    auto typeIter = typeMap.find(heightMapType);
-    if (typeIter == typeMap.end()) {
+    auto typeIter = typeMap->find(heightMapType);
+    if (typeIter == typeMap->end()) {
         return -2; // 类型不存在
     }
 
@@ -533,10 +1000,15 @@ int GetHeightMapY(int blockX, int blockZ, const std::string& heightMapType) {
 // 全局方块配置相关函数
 // --------------------------------------------------------------------------------
 void InitializeGlobalBlockPalette() {
-    globalBlockPalette.emplace_back(Block("minecraft:air", true));
+    // 空气固定为ID 0
+    blockStateRegistry.Intern("minecraft:air");
 }
 
 std::vector<Block> GetGlobalBlockPalette() {
     return globalBlockPalette;
 }
 
+size_t GetGlobalBlockPaletteSize() {
+    return globalBlockPalette.size();
+}
+
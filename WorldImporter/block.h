@@ -3,6 +3,11 @@
 
 #include "config.h"
 #include "nbtutils.h"
+#include "RegionFile.h"
+#include "PalettedContainer.h"
+#include "NibbleArray.h"
+#include "MortonMap.h"
+#include "OcclusionMask.h"
 extern Config config;
 
 #include <vector>
@@ -14,10 +19,7 @@ extern Config config;
 #include <utility>
 #include <cctype>  // for tolower
 #include <regex>   // for regex matching
-
-// 自定义哈希函数声明
-struct pair_hash;
-struct triple_hash;
+#include <memory>
 
 extern std::unordered_set<std::string> solidBlocks; // 改为哈希表
 extern std::unordered_set<std::string> fluidBlocks;
@@ -361,39 +363,214 @@ struct Block {
     }
 };
 
+// 子区块光照标记
+enum SectionLightFlags : uint8_t {
+    SKY_LIGHT_PRESENT = 1 << 0,     // 存档中有 SkyLight
+    BLOCK_LIGHT_PRESENT = 1 << 1,   // 存档中有 BlockLight
+    SKY_LIGHT_MISSING = 1 << 2,     // 子区块存在但没有 SkyLight（GetSkyLight 返回 -1）
+    BLOCK_LIGHT_MISSING = 1 << 3,   // 子区块存在但没有 BlockLight（GetBlockLight 返回 -1）
+    SKY_LIGHT_NEIGHBOR = 1 << 4     // 没有 SkyLight 但相邻子区块有（GetSkyLight 返回 -2）
+};
+
 struct SectionCacheEntry {
-    std::vector<int> skyLight;      // 天空光照数据
-    std::vector<int> blockLight;    // 方块光照数据
-    std::vector<std::string> blockPalette; // 方块调色板
-    std::vector<int> blockData;     // 方块数据
+    NibbleArray skyLight;           // 天空光照数据（2048 字节，未解码时为空）
+    NibbleArray blockLight;         // 方块光照数据（2048 字节，未解码时为空）
+    uint8_t lightFlags = 0;         // SectionLightFlags 组合
+    PalettedContainer blocks;       // 方块数据（局部→全局ID表 + 位压缩下标）
+    OcclusionMask opaque;           // 不透明方块（solidBlocks）位集，解码时生成
     std::vector<int> biomeData;     // 生物群系数据
+    size_t bytes = 0;               // 估算占用内存，用于缓存预算
+    uint64_t lastUse = 0;           // 最近一次访问的时钟值，用于 LRU 淘汰
 };
 
+// 子区块缓存：所有条目以 SectionKey 为键存放在开放寻址表中（条目地址稳定），
+// 设定导出范围后，范围内的查找直接按 (chunkX, chunkZ, sectionY) 偏移索引稠密指针数组
+class SectionStore {
+public:
+    // 设定稠密数组覆盖的范围（含两端，sectionY 为调整后的值），范围过大时只使用哈希表
+    void SetBounds(int chunkXMin, int chunkXMax, int chunkZMin, int chunkZMax, int sectionYMin, int sectionYMax);
+    void ClearBounds();
+
+    SectionCacheEntry* Find(int chunkX, int chunkZ, int sectionY) const {
+        if (InGrid(chunkX, chunkZ, sectionY)) {
+            return grid[GridIndex(chunkX, chunkZ, sectionY)];
+        }
+        const std::unique_ptr<SectionCacheEntry>* entry = entries.find(SectionKey(chunkX, chunkZ, sectionY));
+        return entry ? entry->get() : nullptr;
+    }
+
+    // 不存在时插入空条目
+    SectionCacheEntry& Emplace(int chunkX, int chunkZ, int sectionY);
+    bool Erase(int chunkX, int chunkZ, int sectionY);
+
+    // f(chunkX, chunkZ, sectionY, entry)，遍历期间不能插入或删除
+    template <typename F>
+    void ForEach(F&& f) {
+        entries.forEach([&](uint64_t key, std::unique_ptr<SectionCacheEntry>& entry) {
+            int chunkX, chunkZ, sectionY;
+            DecodeSectionKey(key, chunkX, chunkZ, sectionY);
+            f(chunkX, chunkZ, sectionY, *entry);
+            });
+    }
+
+    size_t size() const { return entries.size(); }
+    void clear();
+
+private:
+    bool InGrid(int chunkX, int chunkZ, int sectionY) const {
+        return static_cast<unsigned>(chunkX - minX) < sizeX &&
+            static_cast<unsigned>(chunkZ - minZ) < sizeZ &&
+            static_cast<unsigned>(sectionY - minY) < sizeY;
+    }
+    size_t GridIndex(int chunkX, int chunkZ, int sectionY) const {
+        return (static_cast<size_t>(chunkX - minX) * sizeZ + static_cast<size_t>(chunkZ - minZ)) * sizeY +
+            static_cast<size_t>(sectionY - minY);
+    }
+
+    MortonMap<std::unique_ptr<SectionCacheEntry>> entries;
+    std::vector<SectionCacheEntry*> grid;
+    int minX = 0, minZ = 0, minY = 0;
+    unsigned sizeX = 0, sizeZ = 0, sizeY = 0;
+};
+
+// 区块缓存统计
+struct CacheStats {
+    uint64_t sectionHits = 0;
+    uint64_t sectionMisses = 0;
+    uint64_t sectionEvictions = 0;
+    uint64_t regionHits = 0;
+    uint64_t regionMisses = 0;
+    uint64_t regionEvictions = 0;
+    uint64_t heightMapEvictions = 0;
+    size_t sectionBytes = 0;        // 当前子区块缓存估算大小
+    size_t peakSectionBytes = 0;    // 峰值
+};
+
+
+// 单个区块的解码结果，由工作线程生成后统一合并到全局缓存
+struct DecodedChunk {
+    int chunkX = 0;
+    int chunkZ = 0;
+    std::unordered_map<std::string, std::vector<int>> heightMaps;   // 高度图类型 -> 256 个高度
+    std::vector<std::pair<int, SectionCacheEntry>> sections;        // 调整后的子区块Y -> 子区块数据
+};
+
+struct ModelData;
+struct WeightedModelData;
+
+// 方块状态解析到的渲染模型，指向 blockstate 模型缓存中的条目
+struct BlockModelHandle {
+    enum Kind : uint8_t {
+        Unresolved,     // 尚未解析，按名称查缓存
+        Missing,        // 缓存中没有该状态的模型
+        Fixed,          // BlockModelCache 中的单一模型
+        Variant,        // VariantModelCache 中的加权随机模型
+        Multipart       // MultipartModelCache 中的部件列表
+    };
+    Kind kind = Unresolved;
+    const ModelData* model = nullptr;
+    const std::vector<WeightedModelData>* variants = nullptr;
+    const std::vector<std::vector<WeightedModelData>>* parts = nullptr;
+};
+
+// 方块状态标记
+enum BlockStateFlags : uint8_t {
+    BLOCK_STATE_AIR = 1 << 0,       // minecraft:air，不产生任何面
+    BLOCK_STATE_SOLID = 1 << 1,     // 在 solidBlocks 中（Block::air 为 false），遮挡相邻面
+    BLOCK_STATE_FLUID = 1 << 2,     // 流体或含水方块（level >= 0）
+    BLOCK_STATE_UNCULLED = 1 << 3   // 模型含 DO_NOT_CULL 面，即使被完全包围也要生成（解析模型时设置）
+};
+
+// 每个方块状态ID的元数据，注册时生成一次，热路径中按ID直接下标访问
+struct BlockStateInfo {
+    uint16_t namespaceId = 0;       // GetNamespaceName 的参数
+    uint8_t flags = 0;              // BlockStateFlags 组合
+    int8_t level = -1;              // 流体高度，非流体为 -1
+    std::string name;               // 带命名空间的标准化名称（GetModifiedNameWithNamespace）
+    std::string key;                // 不带命名空间的标准化状态键（GetModifiedName），用于查模型
+    BlockModelHandle model;         // 由 ProcessBlockstateForBlocks 解析
+};
 
 extern std::vector<Block> globalBlockPalette;
-extern std::unordered_map<std::tuple<int, int, int>, SectionCacheEntry, triple_hash> sectionCache;
+// 与 globalBlockPalette 一一对应
+extern std::vector<BlockStateInfo> blockStateInfos;
+// 越界ID使用的元数据（空气）
+extern const BlockStateInfo unknownBlockStateInfo;
+extern SectionStore sectionCache;
+
+inline const BlockStateInfo& GetBlockStateInfo(int blockId) {
+    return (blockId >= 0 && static_cast<size_t>(blockId) < blockStateInfos.size()) ?
+        blockStateInfos[blockId] : unknownBlockStateInfo;
+}
 
+// 命名空间ID对应的名称
+const std::string& GetNamespaceName(uint16_t namespaceId);
 
-// 获取区块NBT数据的函数
-std::vector<char> GetChunkNBTData(const std::vector<char>& fileData, int x, int z);
-std::vector<char> getRegionFromCache(int regionX, int regionZ);
+
+// 获取区块NBT数据的函数（按区块头中的压缩类型解压）
+std::vector<char> GetChunkNBTData(const RegionFile& region, int x, int z);
+bool GetChunkNBTData(const RegionFile& region, int x, int z, std::vector<char>& decompressedData);
+RegionFilePtr getRegionFromCache(int regionX, int regionZ);
+// 区域文件头中记录的区块修改时间，区块不存在时返回 0
+uint32_t GetChunkTimestamp(int chunkX, int chunkZ);
 
 
 void LoadAndCacheBlockData(int chunkX, int chunkZ);
+
+// 获取子区块缓存（未命中时加载整个 chunk），并更新 LRU 时钟
+SectionCacheEntry& AcquireSection(int chunkX, int chunkZ, int adjustedSectionY);
+// 冻结子区块缓存：AcquireSection 变为只读，可在多个线程中并发调用（需先在主线程预取）
+// 冻结期间不能加载、发布或淘汰缓存
+void FreezeSectionCache(bool frozen);
+// 暂停按预算淘汰：预取一批子区块到网格生成结束之间调用，避免批内子区块互相挤出；
+// 恢复时立即按预算淘汰一次，因此预算最多被一个批次临时超出
+void SuspendCacheEviction(bool suspended);
+// 超出 config.cacheBudgetMB 时按 LRU 淘汰子区块
+void EnforceCacheBudget();
+// 网格生成越过某个 chunk 后释放它的子区块和高度图
+void EvictChunk(int chunkX, int chunkZ);
+// 释放已完成解码的区域文件映射
+void EvictRegion(int regionX, int regionZ);
+const CacheStats& GetCacheStats();
+void PrintCacheStats();
+
+// 线程安全地获取方块全局ID，未注册时追加到全局调色板
+int RegisterBlockName(const std::string& blockName);
+
+// 解码区块到 out（不修改全局缓存，可并发调用）
+bool DecodeChunk(const RegionFile& region, int chunkX, int chunkZ, DecodedChunk& out);
+// 将解码结果合并到 sectionCache / heightMapCache（仅在单线程中调用）
+void PublishDecodedChunk(DecodedChunk& chunk);
+// 多线程加载一组区块，按给定顺序分配任务；主线程随解码进度逐个合并，合并时按预算淘汰
+// 已解码区块在 [adjustedSectionYMin, adjustedSectionYMax] 内缺少的子区块记为空条目
+// 区域文件映射保留在缓存中，由调用方在不再需要时 EvictRegion
+void LoadChunksParallel(const std::vector<std::pair<int, int>>& chunks,
+    int adjustedSectionYMin = 0, int adjustedSectionYMax = -1);
+// 区块在 [adjustedSectionYMin, adjustedSectionYMax] 内的子区块是否都已在缓存中（含不存在的空条目）
+bool IsChunkCached(int chunkX, int chunkZ, int adjustedSectionYMin, int adjustedSectionYMax);
+// 重新判断缓存中所有子区块的 SKY_LIGHT_NEIGHBOR 标记（PublishDecodedChunk 已增量维护，一般无需调用）
 void UpdateSkyLightNeighborFlags();
+// 为导出范围（区块坐标与未调整的子区块Y，含两端）建立稠密子区块索引
+void SetSectionCacheBounds(int chunkXMin, int chunkXMax, int chunkZMin, int chunkZMax, int sectionYMin, int sectionYMax);
 int GetBlockId(int blockX, int blockY, int blockZ);
+// 子区块是否只含一种方块，是则通过 blockId 返回该方块；不存在的子区块视为全空气
+bool IsSectionUniform(int chunkX, int chunkZ, int sectionY, int& blockId);
 
 int GetSkyLight(int blockX, int blockY, int blockZ);
 
 int GetBlockLight(int blockX, int blockY, int blockZ);
 
+// 按子区块内 yzx 下标读取光照（与 GetSkyLight/GetBlockLight 的 -1/-2 标记一致）
+int GetSectionSkyLight(const SectionCacheEntry& section, int yzx);
+int GetSectionBlockLight(const SectionCacheEntry& section, int yzx);
+
 // 获取方块名称转换为Block对象
 Block GetBlockById(int blockId);
 
 // 通过ID获取方块名称
-std::string GetBlockNameById(int blockId);
+const std::string& GetBlockNameById(int blockId);
 
-std::string GetBlockNamespaceById(int blockId);
+const std::string& GetBlockNamespaceById(int blockId);
 
 // 获取方块ID时同时获取相邻方块的air状态，返回当前方块ID
 int GetBlockIdWithNeighbors(int blockX, int blockY, int blockZ, bool* neighborIsAir);
@@ -402,6 +579,8 @@ int GetHeightMapY(int blockX, int blockZ, const std::string& heightMapType);
 
 // 返回全局的block对照表(Block对象)
 std::vector<Block> GetGlobalBlockPalette();
+// 全局方块调色板的长度（只增不减，可用于判断是否有新方块状态）
+size_t GetGlobalBlockPaletteSize();
 
 
 // 初始化，注册"minecraft:air"为ID0
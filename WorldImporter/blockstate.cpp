@@ -4,7 +4,9 @@
 #include <regex>
 #include <random>
 #include <numeric>
+#ifdef _WIN32
 #include <Windows.h>
+#endif
 #include <iostream>
 #include <sstream>
 
@@ -690,55 +692,82 @@ void LoadBlockstateJson(const std::string& namespaceName, const std::vector<std:
     }
 }
 
-ModelData GetRandomModelFromCache(const std::string& namespaceName, const std::string& blockId) {
-    // 先检查主缓存
-    if (BlockModelCache.count(namespaceName) &&
-        BlockModelCache[namespaceName].count(blockId)) {
-        return BlockModelCache[namespaceName][blockId];
+BlockModelHandle ResolveBlockModel(const std::string& namespaceName, const std::string& blockId) {
+    BlockModelHandle handle;
+    handle.kind = BlockModelHandle::Missing;
+
+    // 与原查找顺序一致：主缓存 -> variant 缓存 -> multipart 缓存
+    auto fixedNs = BlockModelCache.find(namespaceName);
+    if (fixedNs != BlockModelCache.end()) {
+        auto it = fixedNs->second.find(blockId);
+        if (it != fixedNs->second.end()) {
+            handle.kind = BlockModelHandle::Fixed;
+            handle.model = &it->second;
+            return handle;
+        }
+    }
+
+    auto variantNs = VariantModelCache.find(namespaceName);
+    if (variantNs != VariantModelCache.end()) {
+        auto it = variantNs->second.find(blockId);
+        if (it != variantNs->second.end()) {
+            handle.kind = BlockModelHandle::Variant;
+            handle.variants = &it->second;
+            return handle;
+        }
     }
 
-    // 检查 variant 缓存
-    if (VariantModelCache.count(namespaceName) &&
-        VariantModelCache[namespaceName].count(blockId)) {
-        auto& models = VariantModelCache[namespaceName][blockId];
+    auto multipartNs = MultipartModelCache.find(namespaceName);
+    if (multipartNs != MultipartModelCache.end()) {
+        auto it = multipartNs->second.find(blockId);
+        if (it != multipartNs->second.end()) {
+            handle.kind = BlockModelHandle::Multipart;
+            handle.parts = &it->second;
+            return handle;
+        }
+    }
+
+    return handle;
+}
+
+// pickWeight(totalWeight) 返回 [1, totalWeight] 中的一个权重值
+template <typename PickWeight>
+static ModelData BuildModelFromHandle(const BlockModelHandle& handle, PickWeight&& pickWeight) {
+
+    switch (handle.kind) {
+    case BlockModelHandle::Fixed:
+        return *handle.model;
+
+    case BlockModelHandle::Variant: {
         int totalWeight = 0;
-        for (const auto& wm : models) {
+        for (const auto& wm : *handle.variants) {
             totalWeight += wm.weight;
         }
 
         if (totalWeight > 0) {
-            static std::random_device rd;
-            static std::mt19937 gen(rd());
-            std::uniform_int_distribution<> dis(1, totalWeight);
-            int randomWeight = dis(gen);
+            int randomWeight = pickWeight(totalWeight);
             int cumulative = 0;
 
-            for (const auto& wm : models) {
+            for (const auto& wm : *handle.variants) {
                 cumulative += wm.weight;
                 if (randomWeight <= cumulative) {
                     return wm.model;
                 }
             }
         }
+        break;
     }
 
-    // 检查 multipart 缓存
-    if (MultipartModelCache.count(namespaceName) &&
-        MultipartModelCache[namespaceName].count(blockId)) {
+    case BlockModelHandle::Multipart: {
         ModelData merged;
-        auto& partList = MultipartModelCache[namespaceName][blockId];
-
-        for (auto& parts : partList) {
+        for (const auto& parts : *handle.parts) {
             int totalWeight = 0;
             for (const auto& wm : parts) {
                 totalWeight += wm.weight;
             }
 
             if (totalWeight > 0) {
-                static std::random_device rd;
-                static std::mt19937 gen(rd());
-                std::uniform_int_distribution<> dis(1, totalWeight);
-                int randomWeight = dis(gen);
+                int randomWeight = pickWeight(totalWeight);
                 int cumulative = 0;
 
                 for (const auto& wm : parts) {
@@ -753,10 +782,174 @@ ModelData GetRandomModelFromCache(const std::string& namespaceName, const std::s
         return merged;
     }
 
+    default:
+        break;
+    }
+
     // 返回空模型
     return ModelData();
 }
 
+ModelData GetModelFromHandle(const BlockModelHandle& handle) {
+    static std::random_device rd;
+    static std::mt19937 gen(rd());
+    return BuildModelFromHandle(handle, [](int totalWeight) {
+        std::uniform_int_distribution<> dis(1, totalWeight);
+        return dis(gen);
+        });
+}
+
+// 方块坐标的随机序列：splitmix64，每次取值推进一步
+static uint64_t PositionSeed(int x, int y, int z) {
+    return (static_cast<uint64_t>(static_cast<uint32_t>(x)) << 32 | static_cast<uint32_t>(z)) ^
+        (static_cast<uint64_t>(static_cast<uint32_t>(y)) * 0x9E3779B97F4A7C15ull);
+}
+
+static int NextPositionWeight(uint64_t& state, int totalWeight) {
+    uint64_t h = (state += 0x9E3779B97F4A7C15ull);
+    h = (h ^ (h >> 30)) * 0xBF58476D1CE4E5B9ull;
+    h = (h ^ (h >> 27)) * 0x94D049BB133111EBull;
+    h ^= h >> 31;
+    return static_cast<int>(h % static_cast<uint64_t>(totalWeight)) + 1;
+}
+
+ModelData GetModelFromHandle(const BlockModelHandle& handle, int x, int y, int z) {
+    // 多部件模型的每个部件依次取序列中的下一个值
+    uint64_t state = PositionSeed(x, y, z);
+    return BuildModelFromHandle(handle, [&state](int totalWeight) {
+        return NextPositionWeight(state, totalWeight);
+        });
+}
+
+const ModelData* PickSingleModel(const BlockModelHandle& handle, int x, int y, int z) {
+    if (handle.kind == BlockModelHandle::Fixed) {
+        return handle.model;
+    }
+    if (handle.kind != BlockModelHandle::Variant) {
+        return nullptr;
+    }
+    int totalWeight = 0;
+    for (const auto& wm : *handle.variants) {
+        totalWeight += wm.weight;
+    }
+    if (totalWeight <= 0) {
+        return nullptr;
+    }
+    uint64_t state = PositionSeed(x, y, z);
+    int randomWeight = NextPositionWeight(state, totalWeight);
+    int cumulative = 0;
+    for (const auto& wm : *handle.variants) {
+        cumulative += wm.weight;
+        if (randomWeight <= cumulative) {
+            return &wm.model;
+        }
+    }
+    return nullptr;
+}
+
+void PickModels(const BlockModelHandle& handle, int x, int y, int z, std::vector<const ModelData*>& models) {
+    models.clear();
+    switch (handle.kind) {
+    case BlockModelHandle::Fixed:
+        models.push_back(handle.model);
+        break;
+
+    case BlockModelHandle::Variant:
+        if (const ModelData* model = PickSingleModel(handle, x, y, z)) {
+            models.push_back(model);
+        }
+        break;
+
+    case BlockModelHandle::Multipart: {
+        // 与 GetModelFromHandle(handle, x, y, z) 相同的取值顺序
+        uint64_t state = PositionSeed(x, y, z);
+        for (const auto& parts : *handle.parts) {
+            int totalWeight = 0;
+            for (const auto& wm : parts) {
+                totalWeight += wm.weight;
+            }
+            if (totalWeight <= 0) continue;
+
+            int randomWeight = NextPositionWeight(state, totalWeight);
+            int cumulative = 0;
+            for (const auto& wm : parts) {
+                cumulative += wm.weight;
+                if (randomWeight <= cumulative) {
+                    models.push_back(&wm.model);
+                    break;
+                }
+            }
+        }
+        break;
+    }
+
+    default:
+        break;
+    }
+}
+
+ModelData GetRandomModelFromCache(const std::string& namespaceName, const std::string& blockId) {
+    return GetModelFromHandle(ResolveBlockModel(namespaceName, blockId));
+}
+
+ModelData GetBlockStateModel(const BlockStateInfo& info) {
+    if (info.model.kind == BlockModelHandle::Unresolved) {
+        return GetRandomModelFromCache(GetNamespaceName(info.namespaceId), info.key);
+    }
+    return GetModelFromHandle(info.model);
+}
+
+ModelData GetBlockStateModel(const BlockStateInfo& info, int x, int y, int z) {
+    if (info.model.kind == BlockModelHandle::Unresolved) {
+        return GetModelFromHandle(ResolveBlockModel(GetNamespaceName(info.namespaceId), info.key), x, y, z);
+    }
+    return GetModelFromHandle(info.model, x, y, z);
+}
+
+// 模型是否含不参与剔除的面
+static bool HasUnculledFace(const ModelData& model) {
+    for (FaceIndex dir : model.faceDirections) {
+        if (dir == FACE_NONE) {
+            return true;
+        }
+    }
+    return false;
+}
+
+void ResolveBlockStateModels() {
+    for (auto& info : blockStateInfos) {
+        info.model = ResolveBlockModel(GetNamespaceName(info.namespaceId), info.key);
+
+        // 任一候选模型含 DO_NOT_CULL 面时，完全被遮挡的该方块也不能跳过
+        bool unculled = false;
+        switch (info.model.kind) {
+        case BlockModelHandle::Fixed:
+            unculled = HasUnculledFace(*info.model.model);
+            break;
+        case BlockModelHandle::Variant:
+            for (const auto& wm : *info.model.variants) {
+                unculled = unculled || HasUnculledFace(wm.model);
+            }
+            break;
+        case BlockModelHandle::Multipart:
+            for (const auto& parts : *info.model.parts) {
+                for (const auto& wm : parts) {
+                    unculled = unculled || HasUnculledFace(wm.model);
+                }
+            }
+            break;
+        default:
+            break;
+        }
+        if (unculled) {
+            info.flags |= BLOCK_STATE_UNCULLED;
+        }
+        else {
+            info.flags &= ~BLOCK_STATE_UNCULLED;
+        }
+    }
+}
+
 void ProcessBlockstateForBlocks(const std::vector<Block>& blocks) {
     std::unordered_map<std::string, std::vector<std::string>> namespaceToBlockIdsMap;
 
@@ -777,6 +970,9 @@ void ProcessBlockstateForBlocks(const std::vector<Block>& blocks) {
        
     }
 
+    // 模型缓存已就绪，为每个方块状态记录模型来源
+    ResolveBlockStateModels();
+
 }
 // --------------------------------------------------------------------------------
 // 全局方块状态处理函数
@@ -58,6 +58,22 @@ nlohmann::json GetBlockstateJson(
 );
 ModelData GetRandomModelFromCache(const std::string& namespaceName, const std::string& blockId);
 
+// 在模型缓存中查找方块状态的模型来源
+BlockModelHandle ResolveBlockModel(const std::string& namespaceName, const std::string& blockId);
+// 按模型来源取模型（variant/multipart 按权重随机）
+ModelData GetModelFromHandle(const BlockModelHandle& handle);
+// 按方块坐标确定性地选择 variant/multipart 模型，可在多个线程中并发调用
+ModelData GetModelFromHandle(const BlockModelHandle& handle, int x, int y, int z);
+// 返回按坐标选中的单个模型（与上面的选择一致），multipart 或缺失时返回 nullptr
+const ModelData* PickSingleModel(const BlockModelHandle& handle, int x, int y, int z);
+// 按坐标选出组成方块的各个模型（multipart 每个部件一个），选择与上面一致，结果写入 models（先清空）
+void PickModels(const BlockModelHandle& handle, int x, int y, int z, std::vector<const ModelData*>& models);
+// 按方块状态元数据取模型，未解析时回退到按名称查找
+ModelData GetBlockStateModel(const BlockStateInfo& info);
+ModelData GetBlockStateModel(const BlockStateInfo& info, int x, int y, int z);
+// 为 blockStateInfos 中的所有状态解析模型来源（模型缓存变化后调用）
+void ResolveBlockStateModels();
+
 // 处理所有方块状态变种并合并模型
 void ProcessAllBlockstateVariants();
 
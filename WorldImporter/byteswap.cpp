@@ -0,0 +1,210 @@
+﻿#include "byteswap.h"
+#include <cstring>
+
+#if defined(_M_X64) || defined(__x86_64__) || defined(_M_IX86) || defined(__i386__)
+#define WI_BYTESWAP_X86 1
+#include <immintrin.h>
+#ifdef _MSC_VER
+#include <intrin.h>
+#define WI_TARGET_AVX2
+#else
+#define WI_TARGET_AVX2 __attribute__((target("avx2")))
+#endif
+#elif defined(__ARM_NEON) || defined(_M_ARM64)
+#define WI_BYTESWAP_NEON 1
+#include <arm_neon.h>
+#endif
+
+// 大端主机上 NBT 数据已经是主机字节序，只需复制
+#if defined(__BYTE_ORDER__) && __BYTE_ORDER__ == __ORDER_BIG_ENDIAN__
+#define WI_HOST_BIG_ENDIAN 1
+#endif
+
+// --------------------------------------------------------------------------------
+// 标量实现（处理 SIMD 剩余的尾部元素）
+// --------------------------------------------------------------------------------
+static inline uint64_t Swap64(uint64_t v) {
+    v = ((v & 0x00FF00FF00FF00FFull) << 8) | ((v >> 8) & 0x00FF00FF00FF00FFull);
+    v = ((v & 0x0000FFFF0000FFFFull) << 16) | ((v >> 16) & 0x0000FFFF0000FFFFull);
+    return (v << 32) | (v >> 32);
+}
+
+static inline uint32_t Swap32(uint32_t v) {
+    v = ((v & 0x00FF00FFu) << 8) | ((v >> 8) & 0x00FF00FFu);
+    return (v << 16) | (v >> 16);
+}
+
+static void ByteSwapScalar64(const char* src, char* dst, size_t count) {
+    for (size_t i = 0; i < count; ++i) {
+        uint64_t v;
+        std::memcpy(&v, src + i * 8, 8);
+        v = Swap64(v);
+        std::memcpy(dst + i * 8, &v, 8);
+    }
+}
+
+static void ByteSwapScalar32(const char* src, char* dst, size_t count) {
+    for (size_t i = 0; i < count; ++i) {
+        uint32_t v;
+        std::memcpy(&v, src + i * 4, 4);
+        v = Swap32(v);
+        std::memcpy(dst + i * 4, &v, 4);
+    }
+}
+
+#ifdef WI_BYTESWAP_X86
+// --------------------------------------------------------------------------------
+// SSE2：先交换每个 16 位字内的两个字节，再用 shufflelo/hi 反转字的顺序
+// --------------------------------------------------------------------------------
+static inline __m128i SwapBytesIn16(__m128i x) {
+    return _mm_or_si128(_mm_slli_epi16(x, 8), _mm_srli_epi16(x, 8));
+}
+
+static void ByteSwapSse2_64(const char* src, char* dst, size_t count) {
+    size_t i = 0;
+    for (; i + 2 <= count; i += 2) {
+        __m128i x = _mm_loadu_si128(reinterpret_cast<const __m128i*>(src + i * 8));
+        x = SwapBytesIn16(x);
+        x = _mm_shufflelo_epi16(x, _MM_SHUFFLE(0, 1, 2, 3));
+        x = _mm_shufflehi_epi16(x, _MM_SHUFFLE(0, 1, 2, 3));
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(dst + i * 8), x);
+    }
+    ByteSwapScalar64(src + i * 8, dst + i * 8, count - i);
+}
+
+static void ByteSwapSse2_32(const char* src, char* dst, size_t count) {
+    size_t i = 0;
+    for (; i + 4 <= count; i += 4) {
+        __m128i x = _mm_loadu_si128(reinterpret_cast<const __m128i*>(src + i * 4));
+        x = SwapBytesIn16(x);
+        x = _mm_shufflelo_epi16(x, _MM_SHUFFLE(2, 3, 0, 1));
+        x = _mm_shufflehi_epi16(x, _MM_SHUFFLE(2, 3, 0, 1));
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(dst + i * 4), x);
+    }
+    ByteSwapScalar32(src + i * 4, dst + i * 4, count - i);
+}
+
+// --------------------------------------------------------------------------------
+// AVX2：vpshufb 一次重排 32 字节
+// --------------------------------------------------------------------------------
+WI_TARGET_AVX2 static void ByteSwapAvx2_64(const char* src, char* dst, size_t count) {
+    const __m256i mask = _mm256_setr_epi8(
+        7, 6, 5, 4, 3, 2, 1, 0, 15, 14, 13, 12, 11, 10, 9, 8,
+        7, 6, 5, 4, 3, 2, 1, 0, 15, 14, 13, 12, 11, 10, 9, 8);
+    size_t i = 0;
+    for (; i + 4 <= count; i += 4) {
+        __m256i x = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(src + i * 8));
+        _mm256_storeu_si256(reinterpret_cast<__m256i*>(dst + i * 8), _mm256_shuffle_epi8(x, mask));
+    }
+    ByteSwapScalar64(src + i * 8, dst + i * 8, count - i);
+}
+
+WI_TARGET_AVX2 static void ByteSwapAvx2_32(const char* src, char* dst, size_t count) {
+    const __m256i mask = _mm256_setr_epi8(
+        3, 2, 1, 0, 7, 6, 5, 4, 11, 10, 9, 8, 15, 14, 13, 12,
+        3, 2, 1, 0, 7, 6, 5, 4, 11, 10, 9, 8, 15, 14, 13, 12);
+    size_t i = 0;
+    for (; i + 8 <= count; i += 8) {
+        __m256i x = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(src + i * 4));
+        _mm256_storeu_si256(reinterpret_cast<__m256i*>(dst + i * 4), _mm256_shuffle_epi8(x, mask));
+    }
+    ByteSwapScalar32(src + i * 4, dst + i * 4, count - i);
+}
+
+// CPU 与操作系统都支持 AVX2 时返回 true（结果只计算一次）
+static bool HasAvx2() {
+    static const bool supported = [] {
+#ifdef _MSC_VER
+        int info[4];
+        __cpuid(info, 0);
+        if (info[0] < 7) return false;
+        __cpuid(info, 1);
+        bool osxsave = (info[2] & (1 << 27)) != 0;
+        bool avx = (info[2] & (1 << 28)) != 0;
+        if (!osxsave || !avx || (_xgetbv(0) & 0x6) != 0x6) return false;
+        __cpuidex(info, 7, 0);
+        return (info[1] & (1 << 5)) != 0;
+#else
+        __builtin_cpu_init();
+        return __builtin_cpu_supports("avx2") != 0;
+#endif
+        }();
+    return supported;
+}
+#endif // WI_BYTESWAP_X86
+
+#ifdef WI_BYTESWAP_NEON
+// --------------------------------------------------------------------------------
+// NEON：vrev64/vrev32 反转每个元素内的字节
+// --------------------------------------------------------------------------------
+static void ByteSwapNeon64(const char* src, char* dst, size_t count) {
+    size_t i = 0;
+    for (; i + 2 <= count; i += 2) {
+        uint8x16_t x = vld1q_u8(reinterpret_cast<const uint8_t*>(src + i * 8));
+        vst1q_u8(reinterpret_cast<uint8_t*>(dst + i * 8), vrev64q_u8(x));
+    }
+    ByteSwapScalar64(src + i * 8, dst + i * 8, count - i);
+}
+
+static void ByteSwapNeon32(const char* src, char* dst, size_t count) {
+    size_t i = 0;
+    for (; i + 4 <= count; i += 4) {
+        uint8x16_t x = vld1q_u8(reinterpret_cast<const uint8_t*>(src + i * 4));
+        vst1q_u8(reinterpret_cast<uint8_t*>(dst + i * 4), vrev32q_u8(x));
+    }
+    ByteSwapScalar32(src + i * 4, dst + i * 4, count - i);
+}
+#endif // WI_BYTESWAP_NEON
+
+// --------------------------------------------------------------------------------
+// 对外接口
+// --------------------------------------------------------------------------------
+void ByteSwapArray64(const void* src, void* dst, size_t count) {
+    const char* in = static_cast<const char*>(src);
+    char* out = static_cast<char*>(dst);
+#if defined(WI_HOST_BIG_ENDIAN)
+    if (in != out) std::memmove(out, in, count * 8);
+#elif defined(WI_BYTESWAP_X86)
+    if (HasAvx2()) {
+        ByteSwapAvx2_64(in, out, count);
+    }
+    else {
+        ByteSwapSse2_64(in, out, count);
+    }
+#elif defined(WI_BYTESWAP_NEON)
+    ByteSwapNeon64(in, out, count);
+#else
+    ByteSwapScalar64(in, out, count);
+#endif
+}
+
+void ByteSwapArray32(const void* src, void* dst, size_t count) {
+    const char* in = static_cast<const char*>(src);
+    char* out = static_cast<char*>(dst);
+#if defined(WI_HOST_BIG_ENDIAN)
+    if (in != out) std::memmove(out, in, count * 4);
+#elif defined(WI_BYTESWAP_X86)
+    if (HasAvx2()) {
+        ByteSwapAvx2_32(in, out, count);
+    }
+    else {
+        ByteSwapSse2_32(in, out, count);
+    }
+#elif defined(WI_BYTESWAP_NEON)
+    ByteSwapNeon32(in, out, count);
+#else
+    ByteSwapScalar32(in, out, count);
+#endif
+}
+
+const char* GetByteSwapBackend() {
+#if defined(WI_HOST_BIG_ENDIAN)
+    return "scalar";
+#elif defined(WI_BYTESWAP_X86)
+    return HasAvx2() ? "AVX2" : "SSE2";
+#elif defined(WI_BYTESWAP_NEON)
+    return "NEON";
+#else
+    return "scalar";
+#endif
+}
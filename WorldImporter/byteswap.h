@@ -0,0 +1,48 @@
+// byteswap.h
+#ifndef BYTESWAP_H
+#define BYTESWAP_H
+
+#include <vector>
+#include <new>
+#include <cstddef>
+#include <cstdint>
+
+// 按 Alignment 字节对齐分配内存的分配器，供 SIMD 读写的数值缓冲使用
+template <typename T, size_t Alignment = 32>
+struct AlignedAllocator {
+    using value_type = T;
+
+    template <typename U>
+    struct rebind { using other = AlignedAllocator<U, Alignment>; };
+
+    AlignedAllocator() noexcept = default;
+    template <typename U>
+    AlignedAllocator(const AlignedAllocator<U, Alignment>&) noexcept {}
+
+    T* allocate(size_t n) {
+        return static_cast<T*>(::operator new(n * sizeof(T), std::align_val_t(Alignment)));
+    }
+    void deallocate(T* p, size_t) noexcept {
+        ::operator delete(p, std::align_val_t(Alignment));
+    }
+
+    template <typename U>
+    bool operator==(const AlignedAllocator<U, Alignment>&) const noexcept { return true; }
+    template <typename U>
+    bool operator!=(const AlignedAllocator<U, Alignment>&) const noexcept { return false; }
+};
+
+// 主机字节序的 LONG_ARRAY / INT_ARRAY 缓冲（32 字节对齐）
+using HostLongBuffer = std::vector<uint64_t, AlignedAllocator<uint64_t>>;
+using HostIntBuffer = std::vector<int32_t, AlignedAllocator<int32_t>>;
+
+// 把 count 个大端 64/32 位整数批量转换为主机字节序写入 dst
+// src 可以不对齐（NBT 负载在缓冲区中的位置任意），dst 可以与 src 相同
+// x86 上运行时选择 AVX2，否则使用 SSE2；ARM 使用 NEON；其他平台逐个转换
+void ByteSwapArray64(const void* src, void* dst, size_t count);
+void ByteSwapArray32(const void* src, void* dst, size_t count);
+
+// 当前使用的实现名称（"AVX2"、"SSE2"、"NEON" 或 "scalar"）
+const char* GetByteSwapBackend();
+
+#endif // BYTESWAP_H
@@ -29,6 +29,13 @@ void WriteConfig(const Config& config, const std::string& configFile) {
     file << "importByBlockType = " << (config.importByBlockType ? "1" : "0") << std::endl;
     file << "pointCloudType = " << config.pointCloudType << std::endl;
     file << "lodLevel = " << config.lodLevel << std::endl;
+    file << "cacheBudgetMB = " << config.cacheBudgetMB << std::endl;
+    file << "incrementalExport = " << (config.incrementalExport ? "1" : "0") << std::endl;
+    file << "decodeLight = " << (config.decodeLight ? "1" : "0") << std::endl;
+    file << "greedyMeshing = " << (config.greedyMeshing ? "1" : "0") << std::endl;
+    file << "lodCenterX = " << config.lodCenterX << std::endl;
+    file << "lodCenterZ = " << config.lodCenterZ << std::endl;
+    file << "lodDistance = " << config.lodDistance << std::endl;
     file << "importFilePath = " << config.importFilePath << std::endl;
     file << "selectedGameVersion = " << config.selectedGameVersion << std::endl;
 
@@ -136,6 +143,27 @@ Config LoadConfig(const std::string& configFile) {
             else if (key == "lodLevel") {
                 config.lodLevel = std::stoi(value);
             }
+            else if (key == "cacheBudgetMB") {
+                config.cacheBudgetMB = std::stoi(value);
+            }
+            else if (key == "incrementalExport") {
+                config.incrementalExport = (value == "1");
+            }
+            else if (key == "decodeLight") {
+                config.decodeLight = (value == "1");
+            }
+            else if (key == "greedyMeshing") {
+                config.greedyMeshing = (value == "1");
+            }
+            else if (key == "lodCenterX") {
+                config.lodCenterX = std::stoi(value);
+            }
+            else if (key == "lodCenterZ") {
+                config.lodCenterZ = std::stoi(value);
+            }
+            else if (key == "lodDistance") {
+                config.lodDistance = std::stoi(value);
+            }
             else if (key == "importFilePath") {
                 config.importFilePath = value;
             }
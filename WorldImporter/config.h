@@ -31,7 +31,14 @@ struct Config {
     bool importByChunk;  // 是否按区块导入
     bool importByBlockType;  // 是否按方块种类导入
     int pointCloudType;  // 实心或空心，0为实心，1为空心
-    int lodLevel;  // LOD等级: 0低，1中，2高
+    int lodLevel;  // LOD等级: 0 原始精度，1 按 2x2x2 降采样，2 按 4x4x4 降采样
+    int cacheBudgetMB;  // 区块缓存内存预算(MB)，0 表示不限制
+    bool incrementalExport;  // 是否启用增量导出（复用 mesh_cache 中未变化区块的网格）
+    bool decodeLight;  // 是否解码光照数值（关闭时只记录子区块是否带光照）
+    bool greedyMeshing;  // 是否合并相邻的同材质完整方块面（贪婪网格）
+    int lodCenterX;  // LOD距离分级的中心X坐标
+    int lodCenterZ;  // LOD距离分级的中心Z坐标
+    int lodDistance;  // 距中心每隔多少格提高一级LOD（0 表示整个区域都用 lodLevel）
     std::string importFilePath; // 导入文件路径
     std::string selectedGameVersion; // 选择的游戏版本
     std::map<std::string, VersionConfig> versionConfigs;  // 按版本存储不同的配置
@@ -39,7 +46,8 @@ struct Config {
     Config()
         : worldPath(""), packagePath(""), biomeMappingFile("config\\jsons\\biomes.json"),solidBlocksFile("config\\jsons\\solids.json"),
         minX(0), minY(0), minZ(0), maxX(0), maxY(0), maxZ(0), status(0), importByChunk(false),
-        importByBlockType(false), pointCloudType(0), lodLevel(0), selectedGameVersion(""),
+        importByBlockType(false), pointCloudType(0), lodLevel(0), cacheBudgetMB(4096), incrementalExport(false),
+        decodeLight(true), greedyMeshing(false), lodCenterX(0), lodCenterZ(0), lodDistance(0), importFilePath(""), selectedGameVersion(""),
         versionConfigs() {
     }
 };
@@ -42,3 +42,23 @@ NbtTagPtr DatFileReader::readDatFile(const std::string& filePath) {
     size_t index = 0;
     return readTag(data, index);
 }
+
+// 解析 .dat 文件为视图文档
+NbtView DatFileReader::readDatDocument(const std::string& filePath, NbtDocument& document,
+    const NbtSchema* schema) {
+    return document.Parse(readFile(filePath), schema);
+}
+
+// 以事件方式遍历 .dat 文件
+bool DatFileReader::visitDatFile(const std::string& filePath, NbtVisitor& visitor) {
+    std::vector<char> data = readFile(filePath);
+    return VisitNbt(data.data(), data.size(), visitor);
+}
+
+// 读取存档名
+std::string DatFileReader::readLevelName(const std::string& filePath) {
+    // 只构建 Data/LevelName 路径，玩家数据等子树不建节点
+    static const NbtSchema schema = NbtSchema().Add("Data/LevelName");
+    NbtDocument document;
+    return std::string(readDatDocument(filePath, document, &schema).at("Data/LevelName").asString());
+}
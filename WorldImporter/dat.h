@@ -5,6 +5,8 @@
 #include <vector>
 #include <string>
 #include "nbtutils.h" // 引入 readTag
+#include "NbtVisitor.h"
+#include "NbtDocument.h"
 #include <zlib.h> // 引入 zlib 库
 
 // 声明读取 NBT 数据的方法
@@ -13,6 +15,17 @@ public:
     // 读取 .dat 文件并返回 NBT 数据
     static NbtTagPtr readDatFile(const std::string& filePath);
 
+    // 解析 .dat 文件到 document（文档持有解压后的数据），返回根节点
+    // schema 不为空时只构建其中注册的路径
+    static NbtView readDatDocument(const std::string& filePath, NbtDocument& document,
+        const NbtSchema* schema = nullptr);
+
+    // 以事件方式遍历 .dat 文件，不构建标签树；visitor 提前停止时返回 false
+    static bool visitDatFile(const std::string& filePath, NbtVisitor& visitor);
+
+    // 读取 Data/LevelName（存档名），其余标签按长度跳过
+    static std::string readLevelName(const std::string& filePath);
+
 private:
     // 辅助方法，用于读取文件内容为字符数组
     static std::vector<char> readFile(const std::string& filePath);
@@ -4,29 +4,37 @@
 #include <iostream>
 #include <fstream>
 #include <stdexcept>
+#include <cstring>
+#ifdef _WIN32
 #include <windows.h>
+#endif
 
 using namespace std;
 
 
 // 解压区块数据
 bool DecompressData(const vector<char>& chunkData, vector<char>& decompressedData) {
+    return DecompressData(chunkData.data(), chunkData.size(), decompressedData);
+}
+
+// 解压区块数据（直接读取映射文件中的负载，无需先拷贝到 vector）
+bool DecompressData(const char* chunkData, size_t chunkSize, vector<char>& decompressedData) {
     // 输出压缩数据的大小
-    //cout << "压缩数据大小: " << chunkData.size() << " 字节" << endl;
+    //cout << "压缩数据大小: " << chunkSize << " 字节" << endl;
 
-    uLongf decompressedSize = chunkData.size() * 10;  // 假设解压后的数据大小为压缩数据的 10 倍
+    uLongf decompressedSize = chunkSize * 10;  // 假设解压后的数据大小为压缩数据的 10 倍
     decompressedData.resize(decompressedSize);
 
     // 调用解压函数
     int result = uncompress(reinterpret_cast<Bytef*>(decompressedData.data()), &decompressedSize,
-        reinterpret_cast<const Bytef*>(chunkData.data()), chunkData.size());
+        reinterpret_cast<const Bytef*>(chunkData), chunkSize);
 
     // 如果输出缓冲区太小，则动态扩展缓冲区
     while (result == Z_BUF_ERROR) {
         decompressedSize *= 2;  // 增加缓冲区大小
         decompressedData.resize(decompressedSize);
         result = uncompress(reinterpret_cast<Bytef*>(decompressedData.data()), &decompressedSize,
-            reinterpret_cast<const Bytef*>(chunkData.data()), chunkData.size());
+            reinterpret_cast<const Bytef*>(chunkData), chunkSize);
 
         //cout << "尝试增加缓冲区大小到: " << decompressedSize << " 字节" << endl;
     }
@@ -44,6 +52,252 @@ bool DecompressData(const vector<char>& chunkData, vector<char>& decompressedDat
     }
 }
 
+// --------------------------------------------------------------------------------
+// 流式解压
+// --------------------------------------------------------------------------------
+namespace {
+    // 线程私有的 inflate 上下文，避免每个区块重复分配 zlib 内部状态
+    struct InflateContext {
+        z_stream stream;
+        bool initialized = false;
+
+        InflateContext() {
+            std::memset(&stream, 0, sizeof(stream));
+        }
+        ~InflateContext() {
+            if (initialized) {
+                inflateEnd(&stream);
+            }
+        }
+
+        // windowBits: 15 为 zlib 头，15 + 16 为 gzip 头
+        bool Reset(int windowBits) {
+            if (!initialized) {
+                initialized = (inflateInit2(&stream, windowBits) == Z_OK);
+                return initialized;
+            }
+            return inflateReset2(&stream, windowBits) == Z_OK;
+        }
+    };
+
+    thread_local InflateContext inflateContext;
+
+    uint32_t ReadLE32(const unsigned char* p) {
+        return static_cast<uint32_t>(p[0]) |
+            (static_cast<uint32_t>(p[1]) << 8) |
+            (static_cast<uint32_t>(p[2]) << 16) |
+            (static_cast<uint32_t>(p[3]) << 24);
+    }
+
+    // deflate 每个输入字节最多展开为约 1032 个输出字节
+    constexpr size_t MaxDeflateRatio = 1032;
+
+    bool InflateStream(const char* data, size_t size, int windowBits, size_t sizeHint, vector<char>& out) {
+        InflateContext& ctx = inflateContext;
+        if (!ctx.Reset(windowBits)) {
+            cerr << "错误: 初始化 zlib 解压上下文失败" << endl;
+            return false;
+        }
+
+        // 已知大小时一次分配到位，否则按压缩数据的 4 倍起步，不足时在原缓冲区后追加
+        // 提示值来自不可信的数据（如 gzip ISIZE），限制在 deflate 的最大压缩比以内
+        size_t capacity = sizeHint > 0 ? std::min(sizeHint, size * MaxDeflateRatio) : size * 4;
+        capacity = std::max<size_t>(capacity, 4096);
+        out.resize(std::max(capacity, out.capacity()));
+
+        z_stream& stream = ctx.stream;
+        stream.next_in = reinterpret_cast<Bytef*>(const_cast<char*>(data));
+        stream.avail_in = static_cast<uInt>(size);
+        size_t produced = 0;
+
+        while (true) {
+            if (produced == out.size()) {
+                out.resize(std::max<size_t>(out.size() * 2, 4096));
+            }
+            stream.next_out = reinterpret_cast<Bytef*>(out.data() + produced);
+            stream.avail_out = static_cast<uInt>(out.size() - produced);
+
+            int result = inflate(&stream, Z_NO_FLUSH);
+            produced = out.size() - stream.avail_out;
+
+            if (result == Z_STREAM_END) {
+                break;
+            }
+            if (result == Z_BUF_ERROR && stream.avail_out != 0) {
+                cerr << "错误: 压缩数据不完整" << endl;
+                return false;
+            }
+            if (result != Z_OK && result != Z_BUF_ERROR) {
+                cerr << "错误: 解压失败，错误代码: " << result << endl;
+                return false;
+            }
+        }
+
+        out.resize(produced);
+        return true;
+    }
+
+    // 解码一个 LZ4 块（原始块格式，无帧头）
+    bool DecodeLZ4Sequences(const unsigned char* src, size_t srcSize, char* dst, size_t dstSize) {
+        const unsigned char* ip = src;
+        const unsigned char* const ipEnd = src + srcSize;
+        char* op = dst;
+        char* const opEnd = dst + dstSize;
+
+        while (ip < ipEnd) {
+            unsigned token = *ip++;
+
+            // 字面量长度
+            size_t literalLength = token >> 4;
+            if (literalLength == 15) {
+                unsigned char b;
+                do {
+                    if (ip >= ipEnd) return false;
+                    b = *ip++;
+                    literalLength += b;
+                } while (b == 255);
+            }
+            if (literalLength > static_cast<size_t>(ipEnd - ip) ||
+                literalLength > static_cast<size_t>(opEnd - op)) {
+                return false;
+            }
+            std::memcpy(op, ip, literalLength);
+            ip += literalLength;
+            op += literalLength;
+
+            // 最后一个序列只有字面量
+            if (ip >= ipEnd) {
+                break;
+            }
+
+            // 匹配偏移与长度
+            if (ipEnd - ip < 2) return false;
+            size_t offset = static_cast<size_t>(ip[0]) | (static_cast<size_t>(ip[1]) << 8);
+            ip += 2;
+            if (offset == 0 || offset > static_cast<size_t>(op - dst)) {
+                return false;
+            }
+
+            size_t matchLength = token & 0x0F;
+            if (matchLength == 15) {
+                unsigned char b;
+                do {
+                    if (ip >= ipEnd) return false;
+                    b = *ip++;
+                    matchLength += b;
+                } while (b == 255);
+            }
+            matchLength += 4;
+            if (matchLength > static_cast<size_t>(opEnd - op)) {
+                return false;
+            }
+
+            // 匹配区间可能与输出重叠，逐字节复制
+            const char* match = op - offset;
+            if (offset >= matchLength) {
+                std::memcpy(op, match, matchLength);
+                op += matchLength;
+            }
+            else {
+                for (size_t i = 0; i < matchLength; ++i) {
+                    *op++ = *match++;
+                }
+            }
+        }
+
+        return op == opEnd;
+    }
+}
+
+bool DecompressLZ4Block(const char* data, size_t size, vector<char>& decompressedData) {
+    // LZ4BlockOutputStream 块头：魔数 "LZ4Block"(8) + 标记(1) + 压缩长度(4) + 原始长度(4) + 校验(4)，均为小端
+    static const char magic[] = { 'L', 'Z', '4', 'B', 'l', 'o', 'c', 'k' };
+    const size_t headerSize = sizeof(magic) + 13;
+    const int methodRaw = 0x10;
+    const int methodLZ4 = 0x20;
+
+    // 先扫描一遍块头，得到准确的输出大小
+    size_t totalSize = 0;
+    for (size_t pos = 0; pos + headerSize <= size;) {
+        const unsigned char* header = reinterpret_cast<const unsigned char*>(data + pos);
+        if (std::memcmp(header, magic, sizeof(magic)) != 0) {
+            cerr << "错误: LZ4 块魔数不匹配" << endl;
+            return false;
+        }
+        uint32_t compressedLength = ReadLE32(header + 9);
+        uint32_t originalLength = ReadLE32(header + 13);
+        if (originalLength == 0) break; // 结束块
+        totalSize += originalLength;
+        pos += headerSize + compressedLength;
+    }
+
+    decompressedData.resize(totalSize);
+    size_t produced = 0;
+    for (size_t pos = 0; pos + headerSize <= size;) {
+        const unsigned char* header = reinterpret_cast<const unsigned char*>(data + pos);
+        int method = header[8] & 0xF0;
+        uint32_t compressedLength = ReadLE32(header + 9);
+        uint32_t originalLength = ReadLE32(header + 13);
+        if (originalLength == 0) break;
+
+        pos += headerSize;
+        if (compressedLength > size - pos || originalLength > totalSize - produced) {
+            cerr << "错误: LZ4 块长度越界" << endl;
+            return false;
+        }
+
+        const unsigned char* block = reinterpret_cast<const unsigned char*>(data + pos);
+        if (method == methodRaw) {
+            if (compressedLength != originalLength) return false;
+            std::memcpy(decompressedData.data() + produced, block, originalLength);
+        }
+        else if (method == methodLZ4) {
+            if (!DecodeLZ4Sequences(block, compressedLength, decompressedData.data() + produced, originalLength)) {
+                cerr << "错误: LZ4 块数据损坏" << endl;
+                return false;
+            }
+        }
+        else {
+            cerr << "错误: 未知的 LZ4 块压缩方式: " << method << endl;
+            return false;
+        }
+
+        produced += originalLength;
+        pos += compressedLength;
+    }
+
+    decompressedData.resize(produced);
+    return true;
+}
+
+bool DecompressChunk(const char* chunkData, size_t chunkSize, uint8_t compressionType, vector<char>& decompressedData) {
+    if (!chunkData || chunkSize == 0) {
+        decompressedData.clear();
+        return false;
+    }
+
+    switch (compressionType & ~COMPRESSION_EXTERNAL) {
+    case COMPRESSION_GZIP: {
+        // gzip 尾部 ISIZE 为原始大小（模 2^32），仅作为预分配提示，InflateStream 会限制其上限
+        size_t sizeHint = 0;
+        if (chunkSize >= 18) {
+            sizeHint = ReadLE32(reinterpret_cast<const unsigned char*>(chunkData + chunkSize - 4));
+        }
+        return InflateStream(chunkData, chunkSize, 15 + 16, sizeHint, decompressedData);
+    }
+    case COMPRESSION_ZLIB:
+        return InflateStream(chunkData, chunkSize, 15, 0, decompressedData);
+    case COMPRESSION_NONE:
+        decompressedData.assign(chunkData, chunkData + chunkSize);
+        return true;
+    case COMPRESSION_LZ4:
+        return DecompressLZ4Block(chunkData, chunkSize, decompressedData);
+    default:
+        cerr << "错误: 未知的区块压缩类型: " << static_cast<int>(compressionType) << endl;
+        return false;
+    }
+}
+
 // 将解压后的数据保存到文件
 bool SaveDecompressedData(const vector<char>& decompressedData, const string& outputFileName) {
     ofstream outFile(outputFileName, ios::binary);
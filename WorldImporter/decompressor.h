@@ -3,11 +3,27 @@
 
 #include <vector>
 #include <string> 
+#include <cstdint>
 
+// 区块压缩类型（区块头第 5 字节）
+enum ChunkCompression : uint8_t {
+    COMPRESSION_GZIP = 1,
+    COMPRESSION_ZLIB = 2,
+    COMPRESSION_NONE = 3,
+    COMPRESSION_LZ4 = 4,          // 1.20.5+，lz4-java LZ4Block 帧格式
+    COMPRESSION_EXTERNAL = 0x80   // 标志位：区块数据存放在 c.X.Z.mcc 外部文件中
+};
 
-
-//zlib解压方法
+//zlib解压方法（旧接口，按 10 倍估算输出大小并整体重试）
 bool DecompressData(const std::vector<char>& chunkData, std::vector<char>& decompressedData);
+bool DecompressData(const char* chunkData, size_t chunkSize, std::vector<char>& decompressedData);
+
+// 按压缩类型解压区块负载（不含外部标志位），结果写入 decompressedData 并覆盖原有内容
+// 使用线程私有的 z_stream 流式解压，decompressedData 的容量在多次调用间复用
+bool DecompressChunk(const char* chunkData, size_t chunkSize, uint8_t compressionType, std::vector<char>& decompressedData);
+
+// 解压 lz4-java LZ4BlockOutputStream 格式的数据
+bool DecompressLZ4Block(const char* data, size_t size, std::vector<char>& decompressedData);
 bool SaveDecompressedData(const std::vector<char>& decompressedData, const std::string& outputFileName);
 
 //gzip解压方法
@@ -3,7 +3,9 @@
 #include <fstream>
 #include <sstream>
 #include <stdexcept>
+#ifdef _WIN32
 #include <windows.h>
+#endif
 #include <locale>
 #include <codecvt>
 #include <random>
@@ -268,10 +270,15 @@ std::wstring string_to_wstring(const std::string& str) {
 
 // 将std::wstring转换为Windows系统默认的多字节编码（通常为 GBK 或 ANSI）
 std::string wstring_to_system_string(const std::wstring& wstr) {
+#ifndef _WIN32
+    // 其他平台的文件系统路径按 UTF-8 编码
+    return wstring_to_string(wstr);
+#else
     int size_needed = WideCharToMultiByte(CP_ACP, 0, wstr.c_str(), (int)wstr.size(), nullptr, 0, nullptr, nullptr);
     std::string str(size_needed, 0);
     WideCharToMultiByte(CP_ACP, 0, wstr.c_str(), (int)wstr.size(), &str[0], size_needed, nullptr, nullptr);
     return str;
+#endif
 }
 
 // 获取文件夹名（路径中的最后一部分）
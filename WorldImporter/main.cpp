@@ -18,6 +18,7 @@
 #include "fileutils.h"
 #include "GlobalCache.h"
 #include "RegionModelExporter.h"
+#include "benchmark.h"
 
 Config config;  // 定义全局变量
 
@@ -220,6 +221,10 @@ int main() {
             // 如果是 0，执行整合包所有方块状态导出逻辑
             ProcessAllBlockstateVariants();
         }
+        else if (config.status == 3) {
+            // 如果是 3，运行性能基准测试
+            RunBenchmarks();
+        }
         // else if (config.status == -1) {
         //     // 如果 status 为 -1，退出程序
         //     cout << "退出程序..." << endl;
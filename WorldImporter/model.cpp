@@ -1,7 +1,10 @@
 #include "model.h"
 #include "fileutils.h"
 #include "EntityBlock.h"
-#include <Windows.h>   
+#ifdef _WIN32
+#include <Windows.h>
+#endif
+#include <filesystem>
 #include <iostream>
 #include <fstream>
 #include <string>
@@ -17,11 +20,16 @@ using namespace std::chrono;
 //---------------- 路径处理 ----------------
 std::string getExecutableDir() {
     // 获取可执行文件路径
+#ifdef _WIN32
     char exePath[MAX_PATH];
     GetModuleFileNameA(NULL, exePath, MAX_PATH);
+    std::string exeDir(exePath);
+#else
+    std::error_code error;
+    std::string exeDir = std::filesystem::read_symlink("/proc/self/exe", error).string();
+#endif
 
     // 提取目录路径
-    std::string exeDir(exePath);
     size_t lastSlash = exeDir.find_last_of("\\/");
     if (lastSlash != std::string::npos) {
         exeDir = exeDir.substr(0, lastSlash + 1);  // 包括最后的斜杠
@@ -165,18 +173,8 @@ static void applyFaceRotation(ModelData& modelData, size_t faceIdx, int angle) {
 void ApplyRotationToUV(ModelData& modelData, int rotationX, int rotationY) {
     createUniqueUVs(modelData);
 
-    // 预处理面类型
-    std::vector<FaceType> faceTypes;
-    faceTypes.reserve(modelData.faceNames.size());
-    for (const auto& name : modelData.faceNames) {
-        if (name == "up") faceTypes.push_back(UP);
-        else if (name == "down") faceTypes.push_back(DOWN);
-        else if (name == "north") faceTypes.push_back(NORTH);
-        else if (name == "south") faceTypes.push_back(SOUTH);
-        else if (name == "west") faceTypes.push_back(WEST);
-        else if (name == "east") faceTypes.push_back(EAST);
-        else faceTypes.push_back(UNKNOWN);
-    }
+    // 面朝向已在解析模型时存为枚举
+    const std::vector<FaceIndex>& faceTypes = modelData.faceNames;
 
     // 根据旋转组合处理UV旋转
     auto getCase = [rotationX, rotationY]() {
@@ -186,7 +184,7 @@ void ApplyRotationToUV(ModelData& modelData, int rotationX, int rotationY) {
     // OpenMP并行处理
 #pragma omp parallel for
     for (int i = 0; i < static_cast<int>(faceTypes.size()); ++i) {
-        const FaceType face = faceTypes[i];
+        const FaceIndex face = faceTypes[i];
         int angle = 0;
 
         const std::string caseKey = getCase();
@@ -195,92 +193,92 @@ void ApplyRotationToUV(ModelData& modelData, int rotationX, int rotationY) {
             // 不旋转
         }
         else if (caseKey == "0-90" || caseKey == "0-180" || caseKey == "0-270") {
-            if (face == UP) angle = -rotationY;
-            else if (face == DOWN) angle = -rotationY;
+            if (face == FACE_UP) angle = -rotationY;
+            else if (face == FACE_DOWN) angle = -rotationY;
         }
         else if (caseKey == "90-0") {
-            if (face == UP) angle = 180;
-            else if (face == EAST) angle = 180;
-            else if (face == WEST) angle = 90;
-            else if (face == NORTH) angle = -90;
+            if (face == FACE_UP) angle = 180;
+            else if (face == FACE_EAST) angle = 180;
+            else if (face == FACE_WEST) angle = 90;
+            else if (face == FACE_NORTH) angle = -90;
         }
         else if (caseKey == "90-90") {
-            if (face == UP) angle = 180;
-            else if (face == EAST) angle = -90;
-            else if (face == DOWN) angle = -90;
-            else if (face == WEST) angle = 90;
-            else if (face == NORTH) angle = -90;
+            if (face == FACE_UP) angle = 180;
+            else if (face == FACE_EAST) angle = -90;
+            else if (face == FACE_DOWN) angle = -90;
+            else if (face == FACE_WEST) angle = 90;
+            else if (face == FACE_NORTH) angle = -90;
         }
         else if (caseKey == "90-180") {
-            if (face == NORTH) angle = 180;
-            else if (face == DOWN) angle = 180;
-            else if (face == WEST) angle = 90;
-            else if (face == UP) angle = -90;
+            if (face == FACE_NORTH) angle = 180;
+            else if (face == FACE_DOWN) angle = 180;
+            else if (face == FACE_WEST) angle = 90;
+            else if (face == FACE_UP) angle = -90;
         }
         else if (caseKey == "90-270") {
-            if (face == UP) angle = 180;
-            else if (face == EAST) angle = 90;
-            else if (face == DOWN) angle = 90;
-            else if (face == WEST) angle = 90;
-            else if (face == NORTH) angle = -90;
+            if (face == FACE_UP) angle = 180;
+            else if (face == FACE_EAST) angle = 90;
+            else if (face == FACE_DOWN) angle = 90;
+            else if (face == FACE_WEST) angle = 90;
+            else if (face == FACE_NORTH) angle = -90;
         }
         else if (caseKey == "180-0") {
-            if (face == UP) angle = rotationY;
-            else if (face == EAST) angle = 180;
-            else if (face == SOUTH) angle = 180;
-            else if (face == WEST) angle = 180;
-            else if (face == NORTH) angle = 180;
-            else if (face == DOWN) angle = rotationY;
+            if (face == FACE_UP) angle = rotationY;
+            else if (face == FACE_EAST) angle = 180;
+            else if (face == FACE_SOUTH) angle = 180;
+            else if (face == FACE_WEST) angle = 180;
+            else if (face == FACE_NORTH) angle = 180;
+            else if (face == FACE_DOWN) angle = rotationY;
         }
         else if (caseKey == "180-90") {
-            if (face == UP) angle = rotationY;
-            else if (face == EAST) angle = 180;
-            else if (face == SOUTH) angle = 180;
-            else if (face == WEST) angle = 180;
-            else if (face == NORTH) angle = 180;
-            else if (face == DOWN) angle = rotationY;
+            if (face == FACE_UP) angle = rotationY;
+            else if (face == FACE_EAST) angle = 180;
+            else if (face == FACE_SOUTH) angle = 180;
+            else if (face == FACE_WEST) angle = 180;
+            else if (face == FACE_NORTH) angle = 180;
+            else if (face == FACE_DOWN) angle = rotationY;
         }
         else if (caseKey == "180-180") {
-            if (face == UP) angle = rotationY;
-            else if (face == EAST) angle = 180;
-            else if (face == SOUTH) angle = 180;
-            else if (face == WEST) angle = 180;
-            else if (face == NORTH) angle = 180;
-            else if (face == DOWN) angle = rotationY;
+            if (face == FACE_UP) angle = rotationY;
+            else if (face == FACE_EAST) angle = 180;
+            else if (face == FACE_SOUTH) angle = 180;
+            else if (face == FACE_WEST) angle = 180;
+            else if (face == FACE_NORTH) angle = 180;
+            else if (face == FACE_DOWN) angle = rotationY;
         }
         else if (caseKey=="180-270") {
-            if (face == UP) angle = rotationY;
-            else if (face == EAST) angle = 180;
-            else if (face == SOUTH) angle = 180;
-            else if (face == WEST) angle = 180;
-            else if (face == NORTH) angle = 180;
-            else if (face == DOWN) angle = rotationY;
+            if (face == FACE_UP) angle = rotationY;
+            else if (face == FACE_EAST) angle = 180;
+            else if (face == FACE_SOUTH) angle = 180;
+            else if (face == FACE_WEST) angle = 180;
+            else if (face == FACE_NORTH) angle = 180;
+            else if (face == FACE_DOWN) angle = rotationY;
         }
         else if (caseKey == "270-0") {
-            if (face == EAST) angle = 180;
-            else if (face == WEST) angle = -90;
-            else if (face == NORTH) angle = 90;
-            else if (face == SOUTH) angle = 180;
+            if (face == FACE_EAST) angle = 180;
+            else if (face == FACE_WEST) angle = -90;
+            else if (face == FACE_NORTH) angle = 90;
+            else if (face == FACE_SOUTH) angle = 180;
         }
         else if (caseKey == "270-90") {
-            if (face == EAST) angle = 90;
-            else if (face == DOWN) angle = 90;
-            else if (face == WEST) angle = -90;
-            else if (face == NORTH) angle = 90;
-            else if (face == SOUTH) angle = 180;
+            if (face == FACE_EAST) angle = 90;
+            else if (face == FACE_DOWN) angle = 90;
+            else if (face == FACE_WEST) angle = -90;
+            else if (face == FACE_NORTH) angle = 90;
+            else if (face == FACE_SOUTH) angle = 180;
         }
         else if (caseKey == "270-180") {
-            if (face == DOWN) angle = 180;
-            else if (face == WEST) angle = -90;
-            else if (face == NORTH) angle = 90;
-            else if (face == SOUTH) angle = 180;
+            if (face == FACE_DOWN) angle = 180;
+            else if (face == FACE_WEST) angle = -90;
+            else if (face == FACE_NORTH) angle = 90;
+            else if (face == FACE_SOUTH) angle = 180;
         }
         else if (caseKey == "270-270") {
-            if (face == EAST) angle = -90;
-            else if (face == DOWN) angle = -90;
-            else if (face == WEST) angle = -90;
-            else if (face == NORTH) angle = 90;
-            else if (face == SOUTH) angle = 180;
+            if (face == FACE_EAST) angle = -90;
+            else if (face == FACE_DOWN) angle = -90;
+            else if (face == FACE_WEST) angle = -90;
+            else if (face == FACE_NORTH) angle = 90;
+            else if (face == FACE_SOUTH) angle = 180;
         }
         else {
             // 未处理的旋转组合
@@ -297,58 +295,11 @@ void ApplyRotationToUV(ModelData& modelData, int rotationX, int rotationY) {
     }
 }
 
-// 旋转函数
-void ApplyRotationToFaceDirections(std::vector<std::string>& faceDirections, int rotationX, int rotationY) {
-    // 定义旋转规则
-    auto rotateY = [](const std::string& direction) -> std::string {
-        if (direction == "north") return "east";
-        else if (direction == "east") return "south";
-        else if (direction == "south") return "west";
-        else if (direction == "west") return "north";
-        else return direction;
-        };
-
-    auto rotateYReverse = [](const std::string& direction) -> std::string {
-        if (direction == "north") return "west";
-        else if (direction == "west") return "south";
-        else if (direction == "south") return "east";
-        else if (direction == "east") return "north";
-        else return direction;
-        };
-
-    auto rotateX = [](const std::string& direction) -> std::string {
-        if (direction == "north") return "up";
-        else if (direction == "up") return "south";
-        else if (direction == "south") return "down";
-        else if (direction == "down") return "north";
-        else return direction;
-        };
-
-    auto rotateXReverse = [](const std::string& direction) -> std::string {
-        if (direction == "north") return "down";
-        else if (direction == "down") return "south";
-        else if (direction == "south") return "up";
-        else if (direction == "up") return "north";
-        else return direction;
-        };
-    // 绕 X 轴旋转（90度增量）
-    for (std::string& dir : faceDirections) {
-        switch (rotationX) {
-        case 270:  dir = rotateX(dir); break;
-        case 180: dir = rotateX(rotateX(dir)); break;
-        case 90: dir = rotateXReverse(dir); break;
-        }
-    }
-    // 绕 Y 轴旋转（90度增量）
-    for (std::string& dir : faceDirections) {
-        switch (rotationY) {
-        case 90:  dir = rotateY(dir); break;
-        case 180: dir = rotateY(rotateY(dir)); break;
-        case 270: dir = rotateYReverse(dir); break;
-        }
+// 旋转函数（查表，见 FaceDirection.h）
+void ApplyRotationToFaceDirections(std::vector<FaceIndex>& faceDirections, int rotationX, int rotationY) {
+    for (FaceIndex& dir : faceDirections) {
+        dir = RotateFace(dir, rotationX, rotationY);
     }
-
-    
 }
 
 //============== 模型数据处理模块 ==============//
@@ -995,21 +946,15 @@ void processElements(const nlohmann::json& modelJson, ModelData& data,
                                 uvIndices[2], uvIndices[3] });
                     }
 
-                    // 处理faceDirections
-                    std::string faceDirection;
-
+                    // 处理faceDirections：无 cullface 的面不参与剔除
+                    FaceIndex faceDirection = FACE_NONE;
                     if (face.value().contains("cullface")) {
-                        faceDirection = face.value()["cullface"].get<std::string>();
-                    }
-                    else {
-                        faceDirection = "DO_NOT_CULL";
+                        faceDirection = ParseFaceIndex(face.value()["cullface"].get<std::string>());
                     }
 
-                    // 将面的方向信息添加到faceDirections
-                    for (int i = 0; i < 4; ++i) {
-                        data.faceDirections.push_back(faceDirection);
-                    }
-                    data.faceNames.push_back(faceName);
+                    // 每个面记录一次剔除方向和朝向
+                    data.faceDirections.push_back(faceDirection);
+                    data.faceNames.push_back(ParseFaceIndex(faceName));
                     // 增加面ID
                     faceId++;
                 }
@@ -1350,6 +1295,83 @@ void MergeModelsDirectly(ModelData& data1, const ModelData& data2) {
             (original_idx != -1) ? materialIndexMap[original_idx] : -1
         );
     }
+
+    // 阶段5：合并面方向，保持每个面一个方向；缺少方向的一方按 FACE_NONE 补齐
+    data1.faceDirections.resize(original_material_count, FACE_NONE);
+    if (data2.faceDirections.size() == data2.materialIndices.size()) {
+        data1.faceDirections.insert(data1.faceDirections.end(),
+            data2.faceDirections.begin(),
+            data2.faceDirections.end());
+    }
+    else {
+        data1.faceDirections.resize(data1.materialIndices.size(), FACE_NONE);
+    }
+}
+
+void AppendModels(ModelData& target, const std::vector<const ModelData*>& parts) {
+    const size_t partCount = parts.size();
+    // 阶段1：预先计算每个部件在目标数组中的起始位置
+    std::vector<size_t> vertexBase(partCount + 1), uvBase(partCount + 1),
+        faceBase(partCount + 1), materialBase(partCount + 1);
+    vertexBase[0] = target.vertices.size();
+    uvBase[0] = target.uvCoordinates.size();
+    faceBase[0] = target.faces.size();
+    materialBase[0] = target.materialIndices.size();
+    for (size_t p = 0; p < partCount; ++p) {
+        vertexBase[p + 1] = vertexBase[p] + parts[p]->vertices.size();
+        uvBase[p + 1] = uvBase[p] + parts[p]->uvCoordinates.size();
+        faceBase[p + 1] = faceBase[p] + parts[p]->faces.size();
+        materialBase[p + 1] = materialBase[p] + parts[p]->materialIndices.size();
+    }
+
+    // 阶段2：按部件顺序建立材质映射（与逐个 MergeModelsDirectly 的编号一致）
+    std::unordered_map<std::string, int> materialLookup;
+    for (size_t i = 0; i < target.materialNames.size(); ++i) {
+        materialLookup.emplace(target.materialNames[i], static_cast<int>(i));
+    }
+    std::vector<std::vector<int>> materialMaps(partCount);
+    for (size_t p = 0; p < partCount; ++p) {
+        const ModelData& part = *parts[p];
+        materialMaps[p].resize(part.materialNames.size());
+        for (size_t i = 0; i < part.materialNames.size(); ++i) {
+            auto inserted = materialLookup.emplace(part.materialNames[i], static_cast<int>(target.materialNames.size()));
+            if (inserted.second) {
+                target.materialNames.push_back(part.materialNames[i]);
+                target.texturePaths.push_back(part.texturePaths[i]);
+            }
+            materialMaps[p][i] = inserted.first->second;
+        }
+    }
+
+    // 阶段3：一次分配后各部件独立填充自己的区段
+    target.vertices.resize(vertexBase[partCount]);
+    target.uvCoordinates.resize(uvBase[partCount]);
+    target.faces.resize(faceBase[partCount]);
+    target.uvFaces.resize(faceBase[partCount]);
+    target.materialIndices.resize(materialBase[partCount]);
+    // 面方向与面一一对应；缺少方向的部件按 FACE_NONE 补齐
+    target.faceDirections.resize(materialBase[0], FACE_NONE);
+    target.faceDirections.resize(materialBase[partCount], FACE_NONE);
+
+#pragma omp parallel for schedule(dynamic)
+    for (int p = 0; p < static_cast<int>(partCount); ++p) {
+        const ModelData& part = *parts[p];
+        const int vertexOffset = static_cast<int>(vertexBase[p] / 3);
+        const int uvOffset = static_cast<int>(uvBase[p] / 2);
+        std::copy(part.vertices.begin(), part.vertices.end(), target.vertices.begin() + vertexBase[p]);
+        std::copy(part.uvCoordinates.begin(), part.uvCoordinates.end(), target.uvCoordinates.begin() + uvBase[p]);
+        for (size_t i = 0; i < part.faces.size(); ++i) {
+            target.faces[faceBase[p] + i] = part.faces[i] + vertexOffset;
+            target.uvFaces[faceBase[p] + i] = part.uvFaces[i] + uvOffset;
+        }
+        for (size_t i = 0; i < part.materialIndices.size(); ++i) {
+            int index = part.materialIndices[i];
+            target.materialIndices[materialBase[p] + i] = (index != -1) ? materialMaps[p][index] : -1;
+        }
+        if (part.faceDirections.size() == part.materialIndices.size()) {
+            std::copy(part.faceDirections.begin(), part.faceDirections.end(), target.faceDirections.begin() + materialBase[p]);
+        }
+    }
 }
 
 
@@ -14,6 +14,7 @@
 #include "texture.h"
 #include "GlobalCache.h"
 #include "version.h"
+#include "FaceDirection.h"
 #pragma once
 
 #define _USE_MATH_DEFINES
@@ -37,12 +38,10 @@ struct ModelData {
     std::vector<std::string> materialNames;
     std::vector<std::string> texturePaths;
 
-    std::vector<std::string> faceDirections; // 每个面的方向
-    std::vector<std::string> faceNames;           // 每个面的名称
+    std::vector<FaceIndex> faceDirections;  // 每个面的剔除方向，FACE_NONE 表示不剔除（DO_NOT_CULL）
+    std::vector<FaceIndex> faceNames;       // 每个面在元素上的朝向（模型 JSON 中 faces 的键）
 };
 
-enum FaceType { UP, DOWN, NORTH, SOUTH, WEST, EAST, UNKNOWN };
-
 //---------------- 缓存管理 ----------------
 static std::mutex cacheMutex;
 static std::recursive_mutex parentModelCacheMutex;
@@ -61,7 +60,11 @@ ModelData ProcessModelJson(const std::string& namespaceName,
 
 // 模型合并
 ModelData MergeModelData(const ModelData& data1, const ModelData& data2);
+// 追加 data2 到 data1；faceDirections 保持每个面一项，缺少方向的面记为 FACE_NONE（不合并 faceNames）
 void MergeModelsDirectly(ModelData& data1, const ModelData& data2);
+// 按顺序把多个模型追加到 target，结果与逐个 MergeModelsDirectly 相同，
+// 偏移预先算出，一次分配后并行复制
+void AppendModels(ModelData& target, const std::vector<const ModelData*>& parts);
 
 
 // exe路径获取
@@ -3,8 +3,11 @@
 #include <cstring>
 #include <iomanip>
 #include <cmath>
+#include <algorithm>
 #include <unordered_map>
 #include "biome.h"
+#include "byteswap.h"
+#include "bitunpack.h"
 
 // 将 TagType 转换为字符串的辅助函数
 std::string tagTypeToString(TagType type) {
@@ -175,6 +178,7 @@ NbtTagPtr readTagPayload(const std::vector<char>& data, size_t& index, TagType t
             if (!child) break; // 遇到TAG_End
             tag->children.push_back(child);
         }
+        tag->BuildNameIndex();
         break;
     }
 
@@ -186,11 +190,9 @@ NbtTagPtr readTagPayload(const std::vector<char>& data, size_t& index, TagType t
             static_cast<uint8_t>(data[index + 3]);
         index += 4;
         if (index + (4 * length) > data.size()) throw std::out_of_range("Not enough data for TAG_Int_Array payload");
-        for (int i = 0; i < length; ++i) {
-            for (int j = 0; j < 4; ++j) {
-                tag->payload.push_back(data[index++]);
-            }
-        }
+        // 整段复制原始大端数据，使用时再批量转换字节序
+        tag->payload.assign(data.begin() + index, data.begin() + index + 4 * static_cast<size_t>(length));
+        index += 4 * static_cast<size_t>(length);
         break;
     }
     case TagType::LONG_ARRAY: {
@@ -201,11 +203,9 @@ NbtTagPtr readTagPayload(const std::vector<char>& data, size_t& index, TagType t
             static_cast<uint8_t>(data[index + 3]);
         index += 4;
         if (index + (8 * length) > data.size()) throw std::out_of_range("Not enough data for TAG_Long_Array payload");
-        for (int i = 0; i < length; ++i) {
-            for (int j = 0; j < 8; ++j) {
-                tag->payload.push_back(data[index++]);
-            }
-        }
+        // 整段复制原始大端数据，使用时再批量转换字节序
+        tag->payload.assign(data.begin() + index, data.begin() + index + 8 * static_cast<size_t>(length));
+        index += 8 * static_cast<size_t>(length);
         break;
     }
 
@@ -327,6 +327,7 @@ NbtTagPtr readTag(const std::vector<char>& data, size_t& index) {
             if (!child) break; // 遇到TAG_End
             tag->children.push_back(child);
         }
+        tag->BuildNameIndex();
         break;
     }
 
@@ -338,11 +339,9 @@ NbtTagPtr readTag(const std::vector<char>& data, size_t& index) {
             static_cast<uint8_t>(data[index + 3]);
         index += 4;
         if (index + (4 * length) > data.size()) throw std::out_of_range("Not enough data for TAG_Int_Array payload");
-        for (int i = 0; i < length; ++i) {
-            for (int j = 0; j < 4; ++j) {
-                tag->payload.push_back(data[index++]);
-            }
-        }
+        // 整段复制原始大端数据，使用时再批量转换字节序
+        tag->payload.assign(data.begin() + index, data.begin() + index + 4 * static_cast<size_t>(length));
+        index += 4 * static_cast<size_t>(length);
         break;
     }
     case TagType::LONG_ARRAY: {
@@ -353,11 +352,9 @@ NbtTagPtr readTag(const std::vector<char>& data, size_t& index) {
             static_cast<uint8_t>(data[index + 3]);
         index += 4;
         if (index + (8 * length) > data.size()) throw std::out_of_range("Not enough data for TAG_Long_Array payload");
-        for (int i = 0; i < length; ++i) {
-            for (int j = 0; j < 8; ++j) {
-                tag->payload.push_back(data[index++]);
-            }
-        }
+        // 整段复制原始大端数据，使用时再批量转换字节序
+        tag->payload.assign(data.begin() + index, data.begin() + index + 8 * static_cast<size_t>(length));
+        index += 8 * static_cast<size_t>(length);
         break;
     }
 
@@ -440,6 +437,7 @@ NbtTagPtr readListTag(const std::vector<char>& data, size_t& index) {
             auto compound = readCompoundTag(data, index);
             if (compound) {
                 elementTag->children = compound->children;
+                elementTag->nameIndex = compound->nameIndex;
             }
             break;
         }
@@ -483,6 +481,7 @@ NbtTagPtr readCompoundTag(const std::vector<char>& data, size_t& index) {
             compoundTag->children.push_back(childTag);
         }
     }
+    compoundTag->BuildNameIndex();
 
     return compoundTag;
 }
@@ -490,6 +489,68 @@ NbtTagPtr readCompoundTag(const std::vector<char>& data, size_t& index) {
 //-------------------------------基础方法---------------------------------------------
 
 
+void NbtTag::BuildNameIndex() {
+    nameIndex.resize(children.size());
+    for (size_t i = 0; i < children.size(); ++i) {
+        nameIndex[i] = static_cast<uint32_t>(i);
+    }
+    // 稳定排序保证重名时仍返回第一个，与线性查找一致
+    std::stable_sort(nameIndex.begin(), nameIndex.end(), [this](uint32_t a, uint32_t b) {
+        return children[a]->name < children[b]->name;
+        });
+}
+
+// 在 COMPOUND 中查找子标签：索引与子标签数量一致时先二分查找，命中即返回；
+// children 可能在建索引后被直接修改，未命中时仍按线性查找兜底
+static NbtTagPtr findChild(const NbtTag& tag, const std::string& childName) {
+    if (!tag.nameIndex.empty() && tag.nameIndex.size() == tag.children.size()) {
+        auto it = std::lower_bound(tag.nameIndex.begin(), tag.nameIndex.end(), childName,
+            [&tag](uint32_t i, const std::string& key) {
+                return tag.children[i]->name < key;
+            });
+        if (it != tag.nameIndex.end() && tag.children[*it]->name == childName) {
+            return tag.children[*it];
+        }
+    }
+
+    for (const auto& child : tag.children) {
+        if (child->name == childName) {
+            return child;
+        }
+    }
+    return nullptr;
+}
+
+NbtTagPtr NbtTag::at(const std::string& path) const {
+    const NbtTag* current = this;
+    NbtTagPtr result;
+    size_t start = 0;
+    while (start <= path.size()) {
+        size_t end = path.find('/', start);
+        if (end == std::string::npos) end = path.size();
+        std::string segment = path.substr(start, end - start);
+        start = end + 1;
+        if (segment.empty()) continue;
+
+        if (current->type == TagType::LIST) {
+            if (segment.find_first_not_of("0123456789") != std::string::npos) return nullptr;
+            size_t elementIndex = std::stoul(segment);
+            if (elementIndex >= current->children.size()) return nullptr;
+            result = current->children[elementIndex];
+        }
+        else if (current->type == TagType::COMPOUND) {
+            result = findChild(*current, segment);
+        }
+        else {
+            return nullptr;
+        }
+
+        if (!result) return nullptr;
+        current = result.get();
+    }
+    return result;
+}
+
 // 通过名字获取子级标签
 NbtTagPtr getChildByName(const NbtTagPtr& tag, const std::string& childName) {
     // 确保 tag 不为空
@@ -504,15 +565,16 @@ NbtTagPtr getChildByName(const NbtTagPtr& tag, const std::string& childName) {
         return nullptr;
     }
 
-    // 处理 COMPOUND 类型，查找名字匹配的子标签
-    for (const auto& child : tag->children) {
-        if (child->name == childName) {
-            return child; // 找到匹配的子标签
-        }
-    }
+    // 处理 COMPOUND 类型，通过名字索引查找匹配的子标签
+    return findChild(*tag, childName);
+}
 
-    // 如果没有找到，返回空指针
-    return nullptr;
+// 按路径获取子孙标签
+NbtTagPtr getTagByPath(const NbtTagPtr& tag, const std::string& path) {
+    if (!tag) {
+        return nullptr;
+    }
+    return tag->at(path);
 }
 
 
@@ -795,30 +857,16 @@ std::vector<int> getBlockStatesData(const NbtTagPtr& blockStatesTag, const std::
         return blockStatesData;  // 返回空的 blockStatesData
     }
 
-    size_t numBlocks = dataTag->payload.size() / sizeof(long long);
-
-    // 计算编码位数
-    size_t numBlockStates = blockPalette.size();
-    int bitsPerState = (numBlockStates <= 16) ? 4 : static_cast<int>(std::ceil(std::log2(numBlockStates)));
-    int statesPerLong = 64 / bitsPerState;  // 每个 long 中可以存储的方块状态数量
-
-    for (size_t i = 0; i < numBlocks; ++i) {
-        long long encodedState;
-
-        // 使用正确的字节顺序读取 long 数据
-        std::memcpy(&encodedState, &dataTag->payload[i * sizeof(long long)], sizeof(long long));
-
-        // 反转字节顺序（如果需要）
-        encodedState = reverseEndian(encodedState);
-
-        // 解析每个 long 数据，根据 YZX 编码获取方块状态的索引
-        for (int j = 0; j < statesPerLong; ++j) {
-            // 根据位数提取对应的方块状态索引
-            int blockStateIndex = (encodedState >> (j * bitsPerState)) & ((1 << bitsPerState) - 1);
-            blockStatesData.push_back(blockStateIndex);
-        }
-    }
+    // 整个数组一次转换为主机字节序
+    size_t numLongs = dataTag->payload.size() / sizeof(long long);
+    thread_local HostLongBuffer words;
+    words.resize(numLongs);
+    ByteSwapArray64(dataTag->payload.data(), words.data(), numLongs);
 
+    // 与解码路径相同的位宽规则和特化内核，解包为恰好 4096 个下标（不含末尾填充）
+    uint16_t indices[SectionVolume];
+    UnpackPaletteIndices(words.data(), words.size(), BlockStateBits(blockPalette.size()), indices);
+    blockStatesData.assign(indices, indices + SectionVolume);
     return blockStatesData;
 }
 
@@ -2,6 +2,8 @@
 #define NBTUTILS_H
 
 #include <string>
+#include <vector>
+#include <cstring>
 #include <memory>
 #include <stdexcept>
 #include <unordered_map>
@@ -36,11 +38,19 @@ struct NbtTag {
     std::vector<char> payload;  // 标签的数据负载
     std::vector<NbtTagPtr> children;  // 子标签列表
     TagType listType;  // LIST标签中元素的类型，默认为END
+    std::vector<uint32_t> nameIndex;  // COMPOUND 子标签按名字排序后的下标，解析时构建；修改 children 后可能过期，查找时会校验
 
     NbtTag(TagType t, const std::string& n)
         : type(t), name(n), listType(TagType::END) {
     }
 
+    // 按 children 重建名字索引，手动增删子标签后需重新调用
+    void BuildNameIndex();
+
+    // 按路径获取子孙标签，例如 at("sections") 或 at("block_states/palette")
+    // LIST 上的数字段表示元素下标，不存在时返回空指针
+    NbtTagPtr at(const std::string& path) const;
+
     // 根据类型获取值
     template <typename T>
     T getValue() const {
@@ -123,6 +133,9 @@ long long reverseEndian(long long value);
 // 通过名字获取子级标签
 NbtTagPtr getChildByName(const NbtTagPtr& tag, const std::string& childName);
 
+// 按路径获取子孙标签（见 NbtTag::at）
+NbtTagPtr getTagByPath(const NbtTagPtr& tag, const std::string& path);
+
 //获取子级标签
 std::vector<NbtTagPtr> getChildren(const NbtTagPtr& tag);
 
@@ -222,11 +222,11 @@ void createObjFileViaMemoryMapped(const ModelData& data, const std::string& objN
     char* ptr = buffer.data();
     //--- 步骤3：优化后的缓冲区填充 ---
     // 文件头（保持原有逻辑）
-    ptr += sprintf_s(ptr, buffer.size() - (ptr - buffer.data()), "mtllib %s\n", mtlFilePath.c_str());
-    ptr += sprintf_s(ptr, buffer.size() - (ptr - buffer.data()), "o %s\n\n", modelName.c_str());
+    ptr += snprintf(ptr, buffer.size() - (ptr - buffer.data()), "mtllib %s\n", mtlFilePath.c_str());
+    ptr += snprintf(ptr, buffer.size() - (ptr - buffer.data()), "o %s\n\n", modelName.c_str());
 
     // 顶点数据（优化后）
-    ptr += sprintf_s(ptr, buffer.size() - (ptr - buffer.data()), "# Vertices (%zu)\n", data.vertices.size() / 3);
+    ptr += snprintf(ptr, buffer.size() - (ptr - buffer.data()), "# Vertices (%zu)\n", data.vertices.size() / 3);
     for (size_t i = 0; i < data.vertices.size(); i += 3) {
         memcpy(ptr, "v ", 2);
         ptr += 2;
@@ -239,7 +239,7 @@ void createObjFileViaMemoryMapped(const ModelData& data, const std::string& objN
     }
 
     // UV数据（优化后）
-    ptr += sprintf_s(ptr, buffer.size() - (ptr - buffer.data()), "\n# UVs (%zu)\n", data.uvCoordinates.size() / 2);
+    ptr += snprintf(ptr, buffer.size() - (ptr - buffer.data()), "\n# UVs (%zu)\n", data.uvCoordinates.size() / 2);
     for (size_t i = 0; i < data.uvCoordinates.size(); i += 2) {
         memcpy(ptr, "vt ", 3);
         ptr += 3;
@@ -250,12 +250,12 @@ void createObjFileViaMemoryMapped(const ModelData& data, const std::string& objN
     }
 
     // 面数据（优化后）
-    ptr += sprintf_s(ptr, buffer.size() - (ptr - buffer.data()), "\n# Faces (%zu)\n", totalFaces);
+    ptr += snprintf(ptr, buffer.size() - (ptr - buffer.data()), "\n# Faces (%zu)\n", totalFaces);
     for (size_t matIndex = 0; matIndex < materialGroups.size(); ++matIndex) {
         const auto& faces = materialGroups[matIndex];
         if (faces.empty()) continue;
 
-        ptr += sprintf_s(ptr, buffer.size() - (ptr - buffer.data()), "usemtl %s\n", data.materialNames[matIndex].c_str());
+        ptr += snprintf(ptr, buffer.size() - (ptr - buffer.data()), "usemtl %s\n", data.materialNames[matIndex].c_str());
         for (const size_t faceIdx : faces) {
             memcpy(ptr, "f ", 2);
             ptr += 2;
@@ -278,6 +278,13 @@ void createObjFileViaMemoryMapped(const ModelData& data, const std::string& objN
     }
 
     //--- 步骤4：内存映射写入 ---
+#ifndef _WIN32
+    // 其他平台直接整块写入
+    std::ofstream objFile(objFilePath, std::ios::binary | std::ios::trunc);
+    if (!objFile.write(buffer.data(), totalSize)) {
+        throw std::runtime_error("Failed to write " + objFilePath);
+    }
+#else
     HANDLE hFile = CreateFileA(
         objFilePath.c_str(),
         GENERIC_READ | GENERIC_WRITE,
@@ -337,6 +344,7 @@ void createObjFileViaMemoryMapped(const ModelData& data, const std::string& objN
     UnmapViewOfFile(mappedData);
     CloseHandle(hMapping);
     CloseHandle(hFile);
+#endif
 }
 
 // 创建 .obj 文件并写入内容
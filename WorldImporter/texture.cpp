@@ -1,8 +1,11 @@
 #include "texture.h"
 #include "fileutils.h"
-#include <Windows.h>   
+#ifdef _WIN32
+#include <Windows.h>
+#endif
 #include <iostream>
 #include <fstream>
+#include <filesystem>
 #include <chrono>
 
 std::vector<unsigned char> GetTextureData(const std::string& namespaceName, const std::string& blockId) {
@@ -31,9 +34,14 @@ bool SaveTextureToFile(const std::string& namespaceName, const std::string& bloc
     // 检查是否找到了纹理数据
     if (!textureData.empty()) {
         // 获取当前工作目录（即 exe 所在的目录）
+#ifdef _WIN32
         char buffer[MAX_PATH];
         GetModuleFileNameA(NULL, buffer, MAX_PATH);
         std::string exePath = std::string(buffer);
+#else
+        std::error_code error;
+        std::string exePath = std::filesystem::read_symlink("/proc/self/exe", error).string();
+#endif
 
         // 获取 exe 所在目录
         size_t pos = exePath.find_last_of("\\/");
@@ -48,12 +56,11 @@ bool SaveTextureToFile(const std::string& namespaceName, const std::string& bloc
         }
 
         // 创建保存目录（如果不存在）
-        if (GetFileAttributesA(savePath.c_str()) == INVALID_FILE_ATTRIBUTES) {
-            // 文件夹不存在，创建它
-            if (!CreateDirectoryA(savePath.c_str(), NULL)) {
-                std::cerr << "Failed to create directory: " << savePath << std::endl;
-                return false;
-            }
+        std::error_code createError;
+        std::filesystem::create_directories(savePath, createError);
+        if (createError) {
+            std::cerr << "Failed to create directory: " << savePath << std::endl;
+            return false;
         }
 
         // 处理 blockId，去掉路径部分，保留最后的文件名
@@ -331,14 +331,8 @@ void GetSaveFiles(const std::wstring& gameFolderPath, std::vector<std::string>&
                 // 检查是否存在 level.dat 文件
                 if (GetFileAttributes(levelDatPath.c_str()) != INVALID_FILE_ATTRIBUTES) {
                     std::string filePath = wstring_to_string(levelDatPath);  // 转换为 std::string
-                    NbtTagPtr rootTag = DatFileReader::readDatFile(filePath);
-
-                    // 获取 "Data" 子标签
-                    NbtTagPtr dataTag = getChildByName(rootTag, "Data");
-
-                    // 获取 "LevelName" 子标签并输出
-                    NbtTagPtr levelNameTag = getChildByName(dataTag, "LevelName");
-                    std::string levelName = getStringTag(levelNameTag);
+                    // 只扫描 Data/LevelName，不构建整个标签树
+                    std::string levelName = DatFileReader::readLevelName(filePath);
 
                     // 将存档文件名添加到列表
                     saveFiles.push_back(levelName);